@@ -0,0 +1,465 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include "VulkanCommandRecycler.h"
+#include "VulkanFrameGraph.h"
+#include "VulkanSample.h"
+#include "VulkanHeadlessBackend.h"
+
+typedef std::chrono::high_resolution_clock Clock;
+
+static const uint32_t BufferCount = 100000;
+static const uint32_t BufferBatchSize = 1000;
+static const VkDeviceSize BufferSize = 4096;
+
+static const uint32_t RecordingFrames = 100;
+static const uint32_t RecordingsPerFrame = 100;
+static const uint32_t RecordingFrameCount = 2;
+static const uint32_t CommandsPerRecording = 16;
+
+static const uint32_t GraphImageCount = 16;
+static const uint32_t GraphIterations = 1000;
+
+static double ElapsedMs(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static bool FindMemoryTypeIndex(VkPhysicalDevice physicalDevice,
+	uint32_t memoryTypeBits,
+	VkMemoryPropertyFlags propertyFlags,
+	uint32_t *memoryTypeIndex)
+{
+	VkPhysicalDeviceMemoryProperties memoryProperties;
+	vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+
+	for (uint32_t index = 0; index < memoryProperties.memoryTypeCount; index++)
+	{
+		if ((memoryTypeBits & (1u << index)) &&
+			(memoryProperties.memoryTypes[index].propertyFlags & propertyFlags) == propertyFlags)
+		{
+			*memoryTypeIndex = index;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static bool CreateDedicatedBuffer(VkDevice device,
+	VkPhysicalDevice physicalDevice,
+	VkBuffer *buffer,
+	VkDeviceMemory *memory)
+{
+	VkBufferCreateInfo createInfo =
+	{
+		VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+		nullptr,
+		0,
+		BufferSize,
+		VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+		VK_SHARING_MODE_EXCLUSIVE,
+		0,
+		nullptr
+	};
+
+	if (vkCreateBuffer(device, &createInfo, nullptr, buffer) != VK_SUCCESS)
+		return false;
+
+	VkMemoryRequirements memoryRequirements;
+	vkGetBufferMemoryRequirements(device, *buffer, &memoryRequirements);
+
+	VkMemoryAllocateInfo allocateInfo =
+	{
+		VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+		nullptr,
+		memoryRequirements.size,
+		0
+	};
+
+	if (!FindMemoryTypeIndex(physicalDevice, memoryRequirements.memoryTypeBits,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &allocateInfo.memoryTypeIndex) ||
+		vkAllocateMemory(device, &allocateInfo, nullptr, memory) != VK_SUCCESS)
+	{
+		vkDestroyBuffer(device, *buffer, nullptr);
+		return false;
+	}
+
+	if (vkBindBufferMemory(device, *buffer, *memory, 0) != VK_SUCCESS)
+	{
+		vkFreeMemory(device, *memory, nullptr);
+		vkDestroyBuffer(device, *buffer, nullptr);
+		return false;
+	}
+
+	return true;
+}
+
+// Creates and destroys 100k buffers with a vkAllocateMemory each, then through the block allocator
+static bool BenchmarkAllocator(VulkanSample &sample)
+{
+	VkDevice device = sample.GetDevice();
+	VkPhysicalDevice physicalDevice = sample.GetPhysicalDevice();
+
+	std::vector<VkBuffer> buffers(BufferBatchSize);
+	std::vector<VkDeviceMemory> memories(BufferBatchSize);
+	std::vector<VulkanAllocation> allocations(BufferBatchSize);
+
+	Clock::time_point start = Clock::now();
+
+	for (uint32_t created = 0; created < BufferCount; created += BufferBatchSize)
+	{
+		for (uint32_t index = 0; index < BufferBatchSize; index++)
+		{
+			if (!CreateDedicatedBuffer(device, physicalDevice, &buffers[index], &memories[index]))
+			{
+				printf("allocator: dedicated buffer creation failed\n");
+				return false;
+			}
+		}
+
+		for (uint32_t index = 0; index < BufferBatchSize; index++)
+		{
+			vkDestroyBuffer(device, buffers[index], nullptr);
+			vkFreeMemory(device, memories[index], nullptr);
+		}
+	}
+
+	double dedicatedMs = ElapsedMs(start);
+	start = Clock::now();
+
+	for (uint32_t created = 0; created < BufferCount; created += BufferBatchSize)
+	{
+		for (uint32_t index = 0; index < BufferBatchSize; index++)
+		{
+			if (!sample.CreateBuffer(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+				BufferSize, VulkanMemoryUsage::GpuOnly, &buffers[index], &allocations[index]))
+			{
+				printf("allocator: sub-allocated buffer creation failed\n");
+				return false;
+			}
+		}
+
+		for (uint32_t index = 0; index < BufferBatchSize; index++)
+			sample.DestroyBuffer(buffers[index], allocations[index]);
+	}
+
+	double allocatorMs = ElapsedMs(start);
+
+	printf("allocator: %u buffers, dedicated %.1f ms (%.2f us/buffer), sub-allocated %.1f ms (%.2f us/buffer)\n",
+		BufferCount, dedicatedMs, dedicatedMs * 1000.0 / BufferCount,
+		allocatorMs, allocatorMs * 1000.0 / BufferCount);
+
+	return true;
+}
+
+static bool RecordCommandBuffer(VkCommandBuffer commandBuffer)
+{
+	VkCommandBufferBeginInfo beginInfo =
+	{
+		VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+		nullptr,
+		VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+		nullptr
+	};
+
+	if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+		return false;
+
+	for (uint32_t command = 0; command < CommandsPerRecording; command++)
+	{
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+			VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 0, nullptr);
+	}
+
+	return vkEndCommandBuffer(commandBuffer) == VK_SUCCESS;
+}
+
+// Records 10k command buffers with vkResetCommandBuffer per buffer, then with a pool reset per frame
+static bool BenchmarkCommandReset(VulkanSample &sample)
+{
+	VkDevice device = sample.GetDevice();
+	uint32_t queueFamilyIndex = sample.GetQueueFamilyIndex(VulkanQueueType::Graphics);
+	uint32_t recordings = RecordingFrames * RecordingsPerFrame;
+
+	VkCommandPoolCreateInfo createInfo =
+	{
+		VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+		nullptr,
+		VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+		queueFamilyIndex
+	};
+
+	VkCommandPool pool = nullptr;
+
+	if (vkCreateCommandPool(device, &createInfo, nullptr, &pool) != VK_SUCCESS)
+	{
+		printf("commands: command pool creation failed\n");
+		return false;
+	}
+
+	std::vector<VkCommandBuffer> buffers(RecordingFrameCount * RecordingsPerFrame);
+
+	VkCommandBufferAllocateInfo allocateInfo =
+	{
+		VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+		nullptr,
+		pool,
+		VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+		static_cast<uint32_t>(buffers.size())
+	};
+
+	if (vkAllocateCommandBuffers(device, &allocateInfo, &buffers[0]) != VK_SUCCESS)
+	{
+		printf("commands: command buffer allocation failed\n");
+		vkDestroyCommandPool(device, pool, nullptr);
+		return false;
+	}
+
+	bool result = true;
+	Clock::time_point start = Clock::now();
+
+	for (uint32_t frame = 0; frame < RecordingFrames && result; frame++)
+	{
+		uint32_t first = (frame % RecordingFrameCount) * RecordingsPerFrame;
+
+		for (uint32_t index = first; index < first + RecordingsPerFrame && result; index++)
+		{
+			result = vkResetCommandBuffer(buffers[index], 0) == VK_SUCCESS &&
+				RecordCommandBuffer(buffers[index]);
+		}
+	}
+
+	double perBufferMs = ElapsedMs(start);
+	vkDestroyCommandPool(device, pool, nullptr);
+
+	VulkanCommandRecycler recycler;
+
+	if (!result || !recycler.Initialize(device, queueFamilyIndex, RecordingFrameCount))
+	{
+		printf("commands: per-buffer recording failed\n");
+		return false;
+	}
+
+	start = Clock::now();
+
+	for (uint32_t frame = 0; frame < RecordingFrames && result; frame++)
+	{
+		result = recycler.Reset(frame);
+
+		for (uint32_t index = 0; index < RecordingsPerFrame && result; index++)
+		{
+			VkCommandBuffer commandBuffer;
+
+			result = recycler.Acquire(frame, VK_COMMAND_BUFFER_LEVEL_PRIMARY, &commandBuffer) &&
+				RecordCommandBuffer(commandBuffer);
+		}
+	}
+
+	double perPoolMs = ElapsedMs(start);
+	recycler.Destroy();
+
+	if (!result)
+	{
+		printf("commands: per-pool recording failed\n");
+		return false;
+	}
+
+	// at 10k recordings per second the recording budget is one second
+	printf("commands: %u recordings, per-buffer reset %.1f ms (%.1f%% of budget), "
+		"per-pool reset %.1f ms (%.1f%% of budget)\n",
+		recordings, perBufferMs, perBufferMs * 100.0 / 1000.0,
+		perPoolMs, perPoolMs * 100.0 / 1000.0);
+
+	return true;
+}
+
+static void BuildFrameGraph(VulkanFrameGraph &frameGraph, 
+	const std::vector<uint32_t> &resources, 
+	uint32_t unusedResource,
+	uint32_t culledPasses)
+{
+	frameGraph.ClearPasses();
+
+	for (uint32_t index = 0; index < static_cast<uint32_t>(resources.size()); index++)
+	{
+		uint32_t pass = frameGraph.AddPass("Pass", [](VkCommandBuffer) {});
+
+		if (index > 0)
+		{
+			frameGraph.Read(pass, resources[index - 1], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+				VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+		}
+
+		frameGraph.Write(pass, resources[index], VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+			VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+	}
+
+	for (uint32_t index = 0; index < culledPasses; index++)
+	{
+		uint32_t pass = frameGraph.AddPass("Culled", [](VkCommandBuffer) {});
+
+		frameGraph.Read(pass, resources[index % resources.size()], VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+		frameGraph.Write(pass, unusedResource, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+			VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+	}
+}
+
+// Compiles a 16 pass chain whose topology changes every iteration, then executes it unchanged per frame
+static bool BenchmarkFrameGraph(VulkanSample &sample)
+{
+	std::vector<VkImage> images(GraphImageCount + 1, nullptr);
+	std::vector<VulkanAllocation> allocations(GraphImageCount + 1);
+	bool result = true;
+
+	for (uint32_t index = 0; index < static_cast<uint32_t>(images.size()) && result; index++)
+	{
+		result = sample.CreateImage(VK_IMAGE_TYPE_2D, false, VK_FORMAT_R8G8B8A8_UNORM, { 64, 64, 1 },
+			1, 1, VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+			VulkanMemoryUsage::GpuOnly, &allocations[index], &images[index]);
+	}
+
+	VulkanFrameGraph frameGraph;
+	VulkanCommandRecycler recycler;
+	std::vector<uint32_t> resources;
+
+	frameGraph.SetSynchronization2(sample.GetCmdPipelineBarrier2());
+
+	for (uint32_t index = 0; index < GraphImageCount; index++)
+		resources.push_back(frameGraph.AddImage("Image", VK_IMAGE_ASPECT_COLOR_BIT, 1, 1));
+
+	uint32_t unusedResource = frameGraph.AddImage("Unused", VK_IMAGE_ASPECT_COLOR_BIT, 1, 1);
+
+	frameGraph.SetOutput(resources.back(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+		VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+
+	result = result && recycler.Initialize(sample.GetDevice(), 
+		sample.GetQueueFamilyIndex(VulkanQueueType::Graphics), 1);
+
+	Clock::time_point start = Clock::now();
+
+	for (uint32_t iteration = 0; iteration < GraphIterations && result; iteration++)
+	{
+		BuildFrameGraph(frameGraph, resources, unusedResource, 1 + iteration % 2);
+		result = frameGraph.Compile();
+	}
+
+	double compileMs = ElapsedMs(start);
+	start = Clock::now();
+
+	for (uint32_t frame = 0; frame < GraphIterations && result; frame++)
+	{
+		VkCommandBuffer commandBuffer;
+
+		for (uint32_t index = 0; index < GraphImageCount; index++)
+			frameGraph.BindImage(resources[index], images[index], VK_IMAGE_LAYOUT_UNDEFINED, 0, 0);
+
+		frameGraph.BindImage(unusedResource, images.back(), VK_IMAGE_LAYOUT_UNDEFINED, 0, 0);
+
+		VkCommandBufferBeginInfo beginInfo =
+		{
+			VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+			nullptr,
+			VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+			nullptr
+		};
+
+		BuildFrameGraph(frameGraph, resources, unusedResource, 2);
+
+		result = recycler.Reset(0) &&
+			recycler.Acquire(0, VK_COMMAND_BUFFER_LEVEL_PRIMARY, &commandBuffer) &&
+			vkBeginCommandBuffer(commandBuffer, &beginInfo) == VK_SUCCESS &&
+			frameGraph.Compile() &&
+			frameGraph.Execute(commandBuffer) &&
+			vkEndCommandBuffer(commandBuffer) == VK_SUCCESS;
+	}
+
+	double executeMs = ElapsedMs(start);
+
+	recycler.Destroy();
+
+	for (uint32_t index = 0; index < static_cast<uint32_t>(images.size()); index++)
+	{
+		if (images[index])
+			sample.DestroyImage(images[index], allocations[index]);
+	}
+
+	if (!result)
+	{
+		printf("framegraph: benchmark failed\n");
+		return false;
+	}
+
+	printf("framegraph: %u passes, compile %.2f us, execute %.2f us per frame (%u compiles)\n",
+		GraphImageCount, compileMs * 1000.0 / GraphIterations, executeMs * 1000.0 / GraphIterations,
+		frameGraph.GetCompileCount());
+
+	return true;
+}
+
+struct Benchmark
+{
+	const char *Name;
+	bool (*Run)(VulkanSample &sample);
+};
+
+static const Benchmark Benchmarks[] =
+{
+	{ "allocator", BenchmarkAllocator },
+	{ "commands", BenchmarkCommandReset },
+	{ "framegraph", BenchmarkFrameGraph }
+};
+
+static bool CreateHeadlessDevice(VulkanSample &sample)
+{
+	sample.SetPresentationBackend(std::unique_ptr<VulkanPresentationBackend>(new VulkanHeadlessBackend()));
+
+	if (!sample.Initialize() || !sample.PopulateInstanceExtensions() || !sample.CreateVulkanInstance({}))
+		return false;
+
+	if (!sample.PopulatePhysicalDevices())
+		return false;
+
+	sample.PopulatePhysicalDeviceFeaturesAndProperties();
+
+	if (!sample.PopulateDeviceExtensions() ||
+		!sample.PopulateQueueFamilyProperties() ||
+		!sample.SelectQueueFamily(VK_QUEUE_GRAPHICS_BIT, false) ||
+		!sample.SelectAsyncQueueFamilies())
+		return false;
+
+	return sample.CreateDevice({}, { 1.0f, 0.8f }) && sample.GetQueues(2);
+}
+
+int main(int argc, char **argv)
+{
+	VulkanSample sample;
+
+	if (!CreateHeadlessDevice(sample))
+	{
+		printf("Unable to create a headless Vulkan device\n");
+		return 1;
+	}
+
+	int result = 0;
+
+	for (const auto& benchmark : Benchmarks)
+	{
+		bool selected = argc < 2;
+
+		for (int i = 1; i < argc; i++)
+		{
+			if (strcmp(argv[i], benchmark.Name) == 0)
+				selected = true;
+		}
+
+		if (selected && !benchmark.Run(sample))
+			result = 1;
+	}
+
+	sample.DestroyDevice();
+	sample.DestroyVulkanInstance();
+
+	return result;
+}
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "Logger.h"
+#include <errno.h>
 #include <stdio.h>
 #include <stdarg.h>
 
@@ -7,9 +8,9 @@ void StdLogger::LogInfo(const char *format, ...)
 	va_list argList;	
 	va_start(argList, format);
 
-	printf_s("[INFO]: ");	
-	vprintf_s(format, argList);
-	printf_s("\r\n");
+	printf("[INFO]: ");	
+	vprintf(format, argList);
+	printf("\r\n");
 
 	va_end(argList);
 }
@@ -19,9 +20,9 @@ void StdLogger::LogWarning(const char *format, ...)
 	va_list argList;
 	va_start(argList, format);
 
-	printf_s("[WARN]: ");
-	vprintf_s(format, argList);
-	printf_s("\r\n");
+	printf("[WARN]: ");
+	vprintf(format, argList);
+	printf("\r\n");
 
 	va_end(argList);
 }
@@ -31,9 +32,9 @@ void StdLogger::LogError(const char *format, ...)
 	va_list argList;
 	va_start(argList, format);
 
-	printf_s("[ERROR]: ");
-	vprintf_s(format, argList);
-	printf_s("\r\n");
+	printf("[ERROR]: ");
+	vprintf(format, argList);
+	printf("\r\n");
 
 	va_end(argList);
 }
@@ -53,10 +54,15 @@ bool FileLogger::Open()
 	if (mFile)
 		Close();
 
+#ifdef _WIN32
 	errno_t err = fopen_s(&mFile, mFileName.c_str(), "w+");
+#else
+	mFile = fopen(mFileName.c_str(), "w+");
+	int err = mFile == nullptr ? errno : 0;
+#endif
 	if (err != 0 || mFile == nullptr)
 	{
-		_ftprintf_s(stderr, _T("Unable to open log: %d"), err);
+		fprintf(stderr, "Unable to open log: %d", err);
 		return false;
 	}
 
@@ -76,9 +82,9 @@ void FileLogger::LogInfo(const char *format, ...)
 	va_list argList;
 	va_start(argList, format);
 
-	fprintf_s(mFile, "[INFO]: ");
-	vfprintf_s(mFile, format, argList);
-	fprintf_s(mFile, "\r\n");
+	fprintf(mFile, "[INFO]: ");
+	vfprintf(mFile, format, argList);
+	fprintf(mFile, "\r\n");
 
 	va_end(argList);
 	fflush(mFile);
@@ -89,9 +95,9 @@ void FileLogger::LogWarning(const char *format, ...)
 	va_list argList;
 	va_start(argList, format);
 
-	fprintf_s(mFile, "[WARN]: ");
-	vfprintf_s(mFile, format, argList);
-	fprintf_s(mFile, "\r\n");
+	fprintf(mFile, "[WARN]: ");
+	vfprintf(mFile, format, argList);
+	fprintf(mFile, "\r\n");
 
 	va_end(argList);
 
@@ -103,9 +109,9 @@ void FileLogger::LogError(const char *format, ...)
 	va_list argList;
 	va_start(argList, format);
 
-	fprintf_s(mFile, "[ERROR]: ");
-	vfprintf_s(mFile, format, argList);
-	fprintf_s(mFile, "\r\n");
+	fprintf(mFile, "[ERROR]: ");
+	vfprintf(mFile, format, argList);
+	fprintf(mFile, "\r\n");
 
 	va_end(argList);
 	fflush(mFile);
@@ -1,6 +1,11 @@
 #pragma once
 
+#ifdef _WIN32
 #include <tchar.h>
+#else
+#define _T(x) x
+#endif
+#include <stdio.h>
 #include <stdarg.h>
 #include <string>
 #include "Singleton.h"
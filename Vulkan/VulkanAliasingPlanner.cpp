@@ -0,0 +1,271 @@
+#include <algorithm>
+#include <cinttypes>
+#include "VulkanAliasingPlanner.h"
+#include "VulkanSample.h"
+
+static VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment)
+{
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+VulkanAliasingPlanner::VulkanAliasingPlanner()
+	: mPlanned(false)
+{
+}
+
+VulkanAliasingPlanner::~VulkanAliasingPlanner()
+{
+}
+
+uint32_t VulkanAliasingPlanner::AddImage(const VulkanAliasedImage &image,
+	const VkMemoryRequirements &memoryRequirements)
+{
+	mResources.push_back({
+		image,
+		memoryRequirements,
+		0,
+		0,
+		false
+	});
+
+	mPlanned = false;
+	return static_cast<uint32_t>(mResources.size() - 1);
+}
+
+void VulkanAliasingPlanner::Clear()
+{
+	mResources.clear();
+	mGroups.clear();
+	mPlanned = false;
+}
+
+bool VulkanAliasingPlanner::Plan()
+{
+	mGroups.clear();
+
+	std::vector<uint32_t> order;
+
+	for (uint32_t index = 0; index < static_cast<uint32_t>(mResources.size()); index++)
+	{
+		const Resource &resource = mResources[index];
+
+		if (resource.Image.FirstPass > resource.Image.LastPass)
+		{
+			LOG_ERROR("Aliased image %d has an inverted pass range, first pass %d after last pass %d", 
+				index, resource.Image.FirstPass, resource.Image.LastPass);
+			return false;
+		}
+
+		order.push_back(index);
+	}
+
+	std::stable_sort(order.begin(), order.end(), [this](uint32_t first, uint32_t second) {
+		return mResources[first].MemoryRequirements.size > mResources[second].MemoryRequirements.size;
+	});
+
+	std::vector<std::vector<uint32_t>> placed;
+
+	for (uint32_t index : order)
+	{
+		Resource &resource = mResources[index];
+
+		uint32_t bestGroup = static_cast<uint32_t>(mGroups.size());
+		VkDeviceSize bestOffset = 0;
+		VkDeviceSize bestGrowth = 0;
+
+		for (uint32_t group = 0; group < static_cast<uint32_t>(mGroups.size()); group++)
+		{
+			if ((mGroups[group].MemoryTypeBits & resource.MemoryRequirements.memoryTypeBits) == 0)
+				continue;
+
+			VkDeviceSize offset = FindOffset(placed[group], resource);
+			VkDeviceSize end = offset + resource.MemoryRequirements.size;
+			VkDeviceSize growth = end > mGroups[group].Size ? end - mGroups[group].Size : 0;
+
+			if (bestGroup == mGroups.size() || growth < bestGrowth)
+			{
+				bestGroup = group;
+				bestOffset = offset;
+				bestGrowth = growth;
+			}
+
+			if (growth == 0)
+				break;
+		}
+
+		if (bestGroup == mGroups.size())
+		{
+			mGroups.push_back({
+				resource.MemoryRequirements.memoryTypeBits,
+				resource.MemoryRequirements.alignment,
+				0
+			});
+
+			placed.emplace_back();
+		}
+
+		Group &group = mGroups[bestGroup];
+
+		group.MemoryTypeBits &= resource.MemoryRequirements.memoryTypeBits;
+		group.Alignment = std::max(group.Alignment, resource.MemoryRequirements.alignment);
+		group.Size = std::max(group.Size, bestOffset + resource.MemoryRequirements.size);
+
+		resource.Group = bestGroup;
+		resource.Offset = bestOffset;
+		resource.Aliased = false;
+
+		placed[bestGroup].push_back(index);
+	}
+
+	for (Resource &resource : mResources)
+	{
+		for (const Resource &other : mResources)
+		{
+			if (&other != &resource && IsMemoryOverlapping(resource, other))
+			{
+				resource.Aliased = true;
+				break;
+			}
+		}
+	}
+
+	LOG_INFO("Aliasing planner packed %u images into %u groups, %" PRIu64 " bytes instead of %" PRIu64,
+		static_cast<uint32_t>(mResources.size()), static_cast<uint32_t>(mGroups.size()),
+		GetAliasedSize(), GetUnaliasedSize());
+
+	mPlanned = true;
+	return true;
+}
+
+VkMemoryRequirements VulkanAliasingPlanner::GetGroupMemoryRequirements(uint32_t group) const
+{
+	return {
+		mGroups[group].Size,
+		mGroups[group].Alignment,
+		mGroups[group].MemoryTypeBits
+	};
+}
+
+void VulkanAliasingPlanner::GetPlacement(uint32_t index, uint32_t *group,
+	VkDeviceSize *offset) const
+{
+	*group = mResources[index].Group;
+	*offset = mResources[index].Offset;
+}
+
+void VulkanAliasingPlanner::GetAliasingTransitions(uint32_t pass,
+	std::vector<ImageMemoryDependency> &transitions) const
+{
+	if (!mPlanned)
+		return;
+
+	for (const Resource &resource : mResources)
+	{
+		if (resource.Image.FirstPass != pass || !resource.Aliased)
+			continue;
+
+		VkPipelineStageFlags srcStages = 0;
+		VkAccessFlags srcAccess = 0;
+		bool earlierFound = false;
+
+		// order every earlier occupant of the same memory before the first write
+		for (const Resource &other : mResources)
+		{
+			if (&other == &resource || !IsMemoryOverlapping(resource, other) ||
+				other.Image.LastPass >= resource.Image.FirstPass)
+				continue;
+
+			srcStages |= other.Image.FinalStages;
+			srcAccess |= other.Image.FinalAccess;
+			earlierFound = true;
+		}
+
+		// without one, the memory was last used by the later occupants of the previous frame
+		if (!earlierFound)
+		{
+			for (const Resource &other : mResources)
+			{
+				if (&other == &resource || !IsMemoryOverlapping(resource, other))
+					continue;
+
+				srcStages |= other.Image.FinalStages;
+				srcAccess |= other.Image.FinalAccess;
+			}
+		}
+
+		transitions.push_back({
+			resource.Image.Image,
+			srcStages,
+			srcAccess,
+			resource.Image.InitialStages,
+			resource.Image.InitialAccess,
+			VK_IMAGE_LAYOUT_UNDEFINED,
+			resource.Image.InitialLayout,
+			{ resource.Image.AspectFlags, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS }
+		});
+	}
+}
+
+VkDeviceSize VulkanAliasingPlanner::GetAliasedSize() const
+{
+	VkDeviceSize size = 0;
+
+	for (const Group &group : mGroups)
+		size += group.Size;
+
+	return size;
+}
+
+VkDeviceSize VulkanAliasingPlanner::GetUnaliasedSize() const
+{
+	VkDeviceSize size = 0;
+
+	for (const Resource &resource : mResources)
+		size += AlignUp(resource.MemoryRequirements.size, resource.MemoryRequirements.alignment);
+
+	return size;
+}
+
+bool VulkanAliasingPlanner::IsLifetimeOverlapping(const Resource &first, const Resource &second) const
+{
+	return first.Image.FirstPass <= second.Image.LastPass &&
+		second.Image.FirstPass <= first.Image.LastPass;
+}
+
+bool VulkanAliasingPlanner::IsMemoryOverlapping(const Resource &first, const Resource &second) const
+{
+	return first.Group == second.Group &&
+		first.Offset < second.Offset + second.MemoryRequirements.size &&
+		second.Offset < first.Offset + first.MemoryRequirements.size;
+}
+
+VkDeviceSize VulkanAliasingPlanner::FindOffset(const std::vector<uint32_t> &placed, 
+	const Resource &resource) const
+{
+	std::vector<std::pair<VkDeviceSize, VkDeviceSize>> occupied;
+
+	for (uint32_t index : placed)
+	{
+		const Resource &other = mResources[index];
+
+		if (!IsLifetimeOverlapping(resource, other))
+			continue;
+
+		occupied.push_back({ other.Offset, other.Offset + other.MemoryRequirements.size });
+	}
+
+	std::sort(occupied.begin(), occupied.end());
+
+	VkDeviceSize offset = 0;
+
+	for (const auto &range : occupied)
+	{
+		if (AlignUp(offset, resource.MemoryRequirements.alignment) + 
+			resource.MemoryRequirements.size <= range.first)
+			break;
+
+		offset = std::max(offset, range.second);
+	}
+
+	return AlignUp(offset, resource.MemoryRequirements.alignment);
+}
\ No newline at end of file
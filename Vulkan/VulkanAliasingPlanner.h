@@ -0,0 +1,89 @@
+#pragma once
+
+#include <vector>
+#include <vulkan/vulkan.h>
+
+struct ImageMemoryDependency;
+
+struct VulkanAliasedImage
+{
+	VkImage Image;
+	VkImageAspectFlags AspectFlags;
+	VkPipelineStageFlags InitialStages;
+	VkAccessFlags InitialAccess;
+	VkImageLayout InitialLayout;
+	VkPipelineStageFlags FinalStages;
+	VkAccessFlags FinalAccess;
+	uint32_t FirstPass;
+	uint32_t LastPass;
+};
+
+class VulkanAliasingPlanner
+{
+private:
+
+	struct Resource
+	{
+		VulkanAliasedImage Image;
+		VkMemoryRequirements MemoryRequirements;
+		uint32_t Group;
+		VkDeviceSize Offset;
+		bool Aliased;
+	};
+
+	struct Group
+	{
+		uint32_t MemoryTypeBits;
+		VkDeviceSize Alignment;
+		VkDeviceSize Size;
+	};
+
+	std::vector<Resource>				mResources;
+	std::vector<Group>					mGroups;
+	bool								mPlanned;
+
+public:
+
+	VulkanAliasingPlanner();
+	~VulkanAliasingPlanner();
+
+	uint32_t GetImageCount() const
+	{
+		return static_cast<uint32_t>(mResources.size());
+	}
+
+	uint32_t GetGroupCount() const
+	{
+		return static_cast<uint32_t>(mGroups.size());
+	}
+
+	const VulkanAliasedImage& GetImage(uint32_t index) const
+	{
+		return mResources[index].Image;
+	}
+
+	uint32_t AddImage(const VulkanAliasedImage &image,
+		const VkMemoryRequirements &memoryRequirements);
+
+	void Clear();
+	bool Plan();
+
+	VkMemoryRequirements GetGroupMemoryRequirements(uint32_t group) const;
+
+	void GetPlacement(uint32_t index, uint32_t *group, 
+		VkDeviceSize *offset) const;
+
+	void GetAliasingTransitions(uint32_t pass, 
+		std::vector<ImageMemoryDependency> &transitions) const;
+
+	VkDeviceSize GetAliasedSize() const;
+	VkDeviceSize GetUnaliasedSize() const;
+
+private:
+
+	bool IsLifetimeOverlapping(const Resource &first, const Resource &second) const;
+	bool IsMemoryOverlapping(const Resource &first, const Resource &second) const;
+
+	VkDeviceSize FindOffset(const std::vector<uint32_t> &placed, 
+		const Resource &resource) const;
+};
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include "VulkanBufferArena.h"
+#include "Logger.h"
+#include <cinttypes>
+
+static VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment)
+{
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+VulkanBufferArena::VulkanBufferArena()
+	: mBuffer(nullptr),
+	mMappedData(nullptr),
+	mAlignment(1),
+	mFrameSize(0),
+	mFrameCount(0),
+	mFrameIndex(0),
+	mHead(0)
+{
+}
+
+VulkanBufferArena::~VulkanBufferArena()
+{
+	Destroy();
+}
+
+bool VulkanBufferArena::Initialize(VkBuffer buffer, void *mappedData,
+	VkDeviceSize frameSize, uint32_t frameCount,
+	VkDeviceSize alignment)
+{
+	if (buffer == nullptr || mappedData == nullptr || frameSize == 0 || frameCount == 0)
+	{
+		LOG_ERROR("Invalid buffer arena parameters");
+		return false;
+	}
+
+	mAlignment = alignment > 0 ? alignment : 1;
+	mFrameSize = AlignUp(frameSize, mAlignment);
+
+	if (mFrameSize * frameCount > UINT32_MAX)
+	{
+		LOG_ERROR("Buffer arena exceeds the dynamic offset range");
+		return false;
+	}
+
+	mBuffer = buffer;
+	mMappedData = static_cast<uint8_t*>(mappedData);
+	mFrameCount = frameCount;
+	mFrameIndex = 0;
+	mHead = 0;
+
+	return true;
+}
+
+void VulkanBufferArena::Destroy()
+{
+	mBuffer = nullptr;
+	mMappedData = nullptr;
+	mAlignment = 1;
+	mFrameSize = 0;
+	mFrameCount = 0;
+	mFrameIndex = 0;
+	mHead = 0;
+}
+
+void VulkanBufferArena::BeginFrame(uint32_t frameIndex)
+{
+	mFrameIndex = mFrameCount > 0 ? frameIndex % mFrameCount : 0;
+	mHead = 0;
+}
+
+bool VulkanBufferArena::Allocate(VkDeviceSize size,
+	uint32_t *dynamicOffset,
+	void **data)
+{
+	VkDeviceSize start = AlignUp(mHead, mAlignment);
+
+	if (size == 0 || start + size > mFrameSize)
+	{
+		LOG_ERROR("Buffer arena is out of space for %" PRIu64 " bytes", size);
+		return false;
+	}
+
+	mHead = start + size;
+
+	*dynamicOffset = static_cast<uint32_t>(GetFrameOffset() + start);
+	*data = mMappedData + *dynamicOffset;
+
+	return true;
+}
\ No newline at end of file
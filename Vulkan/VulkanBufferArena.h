@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+class VulkanBufferArena
+{
+private:
+
+	VkBuffer					mBuffer;
+	uint8_t						*mMappedData;
+	VkDeviceSize				mAlignment;
+	VkDeviceSize				mFrameSize;
+	uint32_t					mFrameCount;
+	uint32_t					mFrameIndex;
+	VkDeviceSize				mHead;
+
+public:
+
+	VulkanBufferArena();
+	~VulkanBufferArena();
+
+	VkBuffer GetBuffer() const
+	{
+		return mBuffer;
+	}
+
+	VkDeviceSize GetFrameSize() const
+	{
+		return mFrameSize;
+	}
+
+	uint32_t GetFrameCount() const
+	{
+		return mFrameCount;
+	}
+
+	VkDeviceSize GetFrameOffset() const
+	{
+		return mFrameSize * mFrameIndex;
+	}
+
+	VkDeviceSize GetUsedSize() const
+	{
+		return mHead;
+	}
+
+	bool Initialize(VkBuffer buffer, void *mappedData,
+		VkDeviceSize frameSize, uint32_t frameCount, 
+		VkDeviceSize alignment);
+
+	void Destroy();
+	void BeginFrame(uint32_t frameIndex);
+
+	bool Allocate(VkDeviceSize size, 
+		uint32_t *dynamicOffset, 
+		void **data);
+};
\ No newline at end of file
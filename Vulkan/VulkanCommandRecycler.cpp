@@ -0,0 +1,143 @@
+#include "VulkanCommandRecycler.h"
+#include "Logger.h"
+
+VulkanCommandRecycler::VulkanCommandRecycler()
+	: mDevice(nullptr)
+{
+}
+
+VulkanCommandRecycler::~VulkanCommandRecycler()
+{
+	Destroy();
+}
+
+bool VulkanCommandRecycler::Initialize(VkDevice device, uint32_t queueFamilyIndex, uint32_t frameCount)
+{
+	if (device == nullptr || frameCount == 0)
+	{
+		LOG_ERROR("Invalid Command recycler parameters");
+		return false;
+	}
+
+	mDevice = device;
+	mFramePools.resize(frameCount);
+
+	for (auto& framePool : mFramePools)
+	{
+		framePool = { nullptr, {}, {}, 0, 0 };
+
+		VkCommandPoolCreateInfo createInfo =
+		{
+			VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+			nullptr,
+			VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+			queueFamilyIndex
+		};
+
+		VkResult result = vkCreateCommandPool(
+			mDevice,
+			&createInfo,
+			nullptr,
+			&framePool.Pool
+		);
+
+		if (result != VK_SUCCESS || framePool.Pool == nullptr)
+		{
+			LOG_ERROR("Unable to create Command recycler pool");
+			Destroy();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void VulkanCommandRecycler::Destroy()
+{
+	for (auto& framePool : mFramePools)
+	{
+		if (framePool.Pool)
+			vkDestroyCommandPool(mDevice, framePool.Pool, nullptr);
+	}
+
+	mFramePools.clear();
+	mDevice = nullptr;
+}
+
+bool VulkanCommandRecycler::Reset(uint32_t frameIndex)
+{
+	FramePool &framePool = mFramePools[frameIndex % mFramePools.size()];
+
+	VkResult result = vkResetCommandPool(
+		mDevice,
+		framePool.Pool,
+		0
+	);
+
+	if (result != VK_SUCCESS)
+	{
+		LOG_ERROR("Unable to reset Command recycler pool");
+		return false;
+	}
+
+	framePool.UsedPrimaryBuffers = 0;
+	framePool.UsedSecondaryBuffers = 0;
+
+	return true;
+}
+
+bool VulkanCommandRecycler::Acquire(uint32_t frameIndex,
+	VkCommandBufferLevel level,
+	VkCommandBuffer *buffer)
+{
+	FramePool &framePool = mFramePools[frameIndex % mFramePools.size()];
+
+	bool primary = level == VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+
+	std::vector<VkCommandBuffer> &buffers = primary ? 
+		framePool.PrimaryBuffers : framePool.SecondaryBuffers;
+
+	uint32_t &usedBuffers = primary ? 
+		framePool.UsedPrimaryBuffers : framePool.UsedSecondaryBuffers;
+
+	if (usedBuffers == buffers.size())
+	{
+		VkCommandBufferAllocateInfo allocateInfo =
+		{
+			VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+			nullptr,
+			framePool.Pool,
+			level,
+			1
+		};
+
+		VkCommandBuffer newBuffer = nullptr;
+
+		VkResult result = vkAllocateCommandBuffers(
+			mDevice,
+			&allocateInfo,
+			&newBuffer
+		);
+
+		if (result != VK_SUCCESS)
+		{
+			LOG_ERROR("Unable to allocate recycled Command buffer");
+			return false;
+		}
+
+		buffers.push_back(newBuffer);
+	}
+
+	*buffer = buffers[usedBuffers++];
+	return true;
+}
+
+uint32_t VulkanCommandRecycler::GetAllocatedCount() const
+{
+	uint32_t count = 0;
+
+	for (const auto& framePool : mFramePools)
+		count += static_cast<uint32_t>(framePool.PrimaryBuffers.size() + framePool.SecondaryBuffers.size());
+
+	return count;
+}
\ No newline at end of file
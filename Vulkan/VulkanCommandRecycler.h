@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vector>
+#include <vulkan/vulkan.h>
+
+class VulkanCommandRecycler
+{
+private:
+
+	struct FramePool
+	{
+		VkCommandPool Pool;
+		std::vector<VkCommandBuffer> PrimaryBuffers;
+		std::vector<VkCommandBuffer> SecondaryBuffers;
+		uint32_t UsedPrimaryBuffers;
+		uint32_t UsedSecondaryBuffers;
+	};
+
+	VkDevice						mDevice;
+	std::vector<FramePool>			mFramePools;
+
+public:
+
+	VulkanCommandRecycler();
+	~VulkanCommandRecycler();
+
+	uint32_t GetFrameCount() const
+	{
+		return static_cast<uint32_t>(mFramePools.size());
+	}
+
+	VkCommandPool GetPool(uint32_t frameIndex) const
+	{
+		return mFramePools[frameIndex % mFramePools.size()].Pool;
+	}
+
+	bool Initialize(VkDevice device, uint32_t queueFamilyIndex, uint32_t frameCount);
+	void Destroy();
+
+	bool Reset(uint32_t frameIndex);
+
+	bool Acquire(uint32_t frameIndex, 
+		VkCommandBufferLevel level, 
+		VkCommandBuffer *buffer);
+
+	uint32_t GetAllocatedCount() const;
+};
\ No newline at end of file
@@ -0,0 +1,182 @@
+#include "VulkanFenceWatcher.h"
+#include "Logger.h"
+
+VulkanFenceWatcher::VulkanFenceWatcher()
+	: mDevice(nullptr),
+	mPollTimeout(0),
+	mWaiting(false),
+	mExit(false)
+{
+}
+
+VulkanFenceWatcher::~VulkanFenceWatcher()
+{
+	Destroy();
+}
+
+bool VulkanFenceWatcher::Initialize(VkDevice device, uint64_t pollTimeout)
+{
+	if (device == nullptr)
+	{
+		LOG_ERROR("Invalid fence watcher device");
+		return false;
+	}
+
+	Destroy();
+
+	mDevice = device;
+	mPollTimeout = pollTimeout;
+	mExit = false;
+	mThread = std::thread(&VulkanFenceWatcher::WatcherMain, this);
+
+	return true;
+}
+
+void VulkanFenceWatcher::Destroy()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mExit = true;
+	}
+
+	mWatchCondition.notify_all();
+
+	if (mThread.joinable())
+		mThread.join();
+
+	for (auto& watch : mWatches)
+		watch.Result = VK_NOT_READY;
+
+	Finish(mWatches);
+	mDevice = nullptr;
+}
+
+std::future<VkResult> VulkanFenceWatcher::Add(VkFence fence, const Callback &callback,
+	uint64_t timeout)
+{
+	Clock::time_point deadline = timeout >= static_cast<uint64_t>(std::chrono::nanoseconds::max().count()) ?
+		Clock::time_point::max() : Clock::now() + std::chrono::nanoseconds(timeout);
+
+	Watch watch = { fence, deadline, callback, VK_NOT_READY };
+	std::future<VkResult> future = watch.Promise.get_future();
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mWatches.push_back(std::move(watch));
+	}
+
+	mWatchCondition.notify_one();
+	return future;
+}
+
+void VulkanFenceWatcher::Complete(VkFence fence)
+{
+	std::vector<Watch> completed;
+	std::unique_lock<std::mutex> lock(mMutex);
+
+	for (size_t index = 0; index < mWatches.size();)
+	{
+		if (mWatches[index].Fence == fence)
+		{
+			mWatches[index].Result = VK_SUCCESS;
+			completed.push_back(std::move(mWatches[index]));
+			mWatches.erase(mWatches.begin() + index);
+		}
+		else
+		{
+			index++;
+		}
+	}
+
+	if (completed.empty())
+		return;
+
+	mIdleCondition.wait(lock, [this] { return !mWaiting; });
+	lock.unlock();
+
+	Finish(completed);
+}
+
+void VulkanFenceWatcher::WatcherMain()
+{
+	std::vector<VkFence> fences;
+	std::vector<Watch> completed;
+	std::unique_lock<std::mutex> lock(mMutex);
+
+	while (true)
+	{
+		mWatchCondition.wait(lock, [this] { return mExit || !mWatches.empty(); });
+
+		if (mExit)
+			break;
+
+		fences.clear();
+
+		for (const auto& watch : mWatches)
+			fences.push_back(watch.Fence);
+
+		mWaiting = true;
+		lock.unlock();
+
+		VkResult result = vkWaitForFences(
+			mDevice,
+			static_cast<uint32_t>(fences.size()),
+			&fences[0],
+			VK_FALSE,
+			mPollTimeout
+		);
+
+		lock.lock();
+		mWaiting = false;
+		mIdleCondition.notify_all();
+
+		Clock::time_point now = Clock::now();
+
+		for (size_t index = 0; index < mWatches.size();)
+		{
+			VkResult status = result;
+
+			if (result == VK_SUCCESS)
+				status = vkGetFenceStatus(mDevice, mWatches[index].Fence);
+			else if (result == VK_TIMEOUT)
+				status = VK_NOT_READY;
+
+			if (status == VK_NOT_READY && now >= mWatches[index].Deadline)
+				status = VK_TIMEOUT;
+
+			if (status == VK_NOT_READY)
+			{
+				index++;
+				continue;
+			}
+
+			if (status == VK_TIMEOUT)
+				LOG_WARN("Watching fence timed out");
+			else if (status == VK_ERROR_DEVICE_LOST)
+				LOG_ERROR("Device lost while watching fence");
+			else if (status != VK_SUCCESS)
+				LOG_ERROR("Watching fence failed");
+
+			mWatches[index].Result = status;
+			completed.push_back(std::move(mWatches[index]));
+			mWatches.erase(mWatches.begin() + index);
+		}
+
+		lock.unlock();
+		Finish(completed);
+		lock.lock();
+	}
+}
+
+void VulkanFenceWatcher::Finish(std::vector<Watch> &watches)
+{
+	for (auto& watch : watches)
+	{
+		if (watch.OnComplete)
+			watch.OnComplete(watch.Result);
+
+		watch.Promise.set_value(watch.Result);
+	}
+
+	watches.clear();
+}
\ No newline at end of file
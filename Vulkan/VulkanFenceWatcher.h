@@ -0,0 +1,62 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+class VulkanFenceWatcher
+{
+public:
+
+	// Callbacks run on the watcher thread
+	typedef std::function<void(VkResult result)> Callback;
+
+private:
+
+	typedef std::chrono::steady_clock Clock;
+
+	struct Watch
+	{
+		VkFence Fence;
+		Clock::time_point Deadline;
+		Callback OnComplete;
+		VkResult Result;
+		std::promise<VkResult> Promise;
+	};
+
+	VkDevice						mDevice;
+	uint64_t						mPollTimeout;
+	std::thread						mThread;
+	std::mutex						mMutex;
+	std::condition_variable			mWatchCondition;
+	std::condition_variable			mIdleCondition;
+	std::vector<Watch>				mWatches;
+	bool							mWaiting;
+	bool							mExit;
+
+public:
+
+	VulkanFenceWatcher();
+	~VulkanFenceWatcher();
+
+	bool Initialize(VkDevice device, uint64_t pollTimeout = 1000000);
+	void Destroy();
+
+	// Watches that outlive the timeout complete with VK_TIMEOUT, checked once per poll
+	std::future<VkResult> Add(VkFence fence, const Callback &callback = nullptr, 
+		uint64_t timeout = UINT64_MAX);
+
+	// Completes watches of a fence the caller has already seen signaled,
+	// must be called before that fence is reset or destroyed
+	void Complete(VkFence fence);
+
+private:
+
+	void WatcherMain();
+	void Finish(std::vector<Watch> &watches);
+};
\ No newline at end of file
@@ -0,0 +1,307 @@
+#include <algorithm>
+#include "VulkanFrameGraph.h"
+#include "Logger.h"
+
+VulkanFrameGraph::VulkanFrameGraph()
+	: mCompileCount(0)
+{
+}
+
+VulkanFrameGraph::~VulkanFrameGraph()
+{
+}
+
+void VulkanFrameGraph::SetSynchronization2(PFN_vkCmdPipelineBarrier2KHR cmdPipelineBarrier2)
+{
+	mStateTracker.SetSynchronization2(cmdPipelineBarrier2);
+}
+
+uint32_t VulkanFrameGraph::AddImage(const std::string &name,
+	VkImageAspectFlags aspectFlags,
+	uint32_t mipLevels,
+	uint32_t arrayLayers)
+{
+	mResources.push_back({ name, nullptr, nullptr, aspectFlags, mipLevels, arrayLayers, false });
+	return static_cast<uint32_t>(mResources.size() - 1);
+}
+
+uint32_t VulkanFrameGraph::AddBuffer(const std::string &name)
+{
+	mResources.push_back({ name, nullptr, nullptr, 0, 0, 0, false });
+	return static_cast<uint32_t>(mResources.size() - 1);
+}
+
+void VulkanFrameGraph::BindImage(uint32_t resource,
+	VkImage image,
+	VkImageLayout layout,
+	VkAccessFlags access,
+	VkPipelineStageFlags stages)
+{
+	Resource &imageResource = mResources[resource];
+
+	imageResource.Image = image;
+
+	mStateTracker.TrackImage(image, imageResource.AspectFlags, imageResource.MipLevels,
+		imageResource.ArrayLayers, layout, access, stages);
+}
+
+void VulkanFrameGraph::BindBuffer(uint32_t resource, VkBuffer buffer)
+{
+	mResources[resource].Buffer = buffer;
+}
+
+void VulkanFrameGraph::SetOutput(uint32_t resource,
+	VkImageLayout layout,
+	VkAccessFlags access,
+	VkPipelineStageFlags stages)
+{
+	Resource &outputResource = mResources[resource];
+
+	outputResource.Output = true;
+	outputResource.OutputLayout = layout;
+	outputResource.OutputAccess = access;
+	outputResource.OutputStages = stages;
+}
+
+uint32_t VulkanFrameGraph::AddPass(const std::string &name, const Callback &callback)
+{
+	mPasses.push_back({ name, callback });
+	return static_cast<uint32_t>(mPasses.size() - 1);
+}
+
+void VulkanFrameGraph::ClearPasses()
+{
+	mPasses.clear();
+}
+
+void VulkanFrameGraph::Read(uint32_t pass, uint32_t resource,
+	VkImageLayout layout,
+	VkAccessFlags access,
+	VkPipelineStageFlags stages)
+{
+	mPasses[pass].Accesses.push_back({ resource, false, layout, access, stages });
+}
+
+void VulkanFrameGraph::Write(uint32_t pass, uint32_t resource,
+	VkImageLayout layout,
+	VkAccessFlags access,
+	VkPipelineStageFlags stages)
+{
+	mPasses[pass].Accesses.push_back({ resource, true, layout, access, stages });
+}
+
+bool VulkanFrameGraph::Compile()
+{
+	std::vector<uint64_t> signature;
+	BuildSignature(signature);
+
+	if (mCompileCount > 0 && signature == mCompiledSignature)
+		return true;
+
+	uint32_t passCount = static_cast<uint32_t>(mPasses.size());
+	std::vector<std::vector<uint32_t>> dependencies;
+	std::vector<bool> alive(passCount, false);
+
+	BuildDependencies(dependencies);
+
+	for (uint32_t pass = passCount; pass-- > 0;)
+	{
+		for (const auto& access : mPasses[pass].Accesses)
+		{
+			if (access.Write && mResources[access.Resource].Output)
+				alive[pass] = true;
+		}
+
+		if (!alive[pass])
+			continue;
+
+		for (uint32_t dependency : dependencies[pass])
+			alive[dependency] = true;
+	}
+
+	std::vector<uint32_t> scheduledAt(passCount, UINT32_MAX);
+
+	mSchedule.clear();
+
+	while (true)
+	{
+		uint32_t bestPass = UINT32_MAX;
+		uint32_t bestDistance = 0;
+
+		for (uint32_t pass = 0; pass < passCount; pass++)
+		{
+			if (!alive[pass] || scheduledAt[pass] != UINT32_MAX)
+				continue;
+
+			bool isReady = true;
+			uint32_t latestDependency = 0;
+
+			for (uint32_t dependency : dependencies[pass])
+			{
+				if (scheduledAt[dependency] == UINT32_MAX)
+				{
+					isReady = false;
+					break;
+				}
+
+				latestDependency = std::max(latestDependency, scheduledAt[dependency] + 1);
+			}
+
+			if (!isReady)
+				continue;
+
+			uint32_t distance = static_cast<uint32_t>(mSchedule.size()) - latestDependency;
+
+			if (bestPass == UINT32_MAX || distance > bestDistance)
+			{
+				bestPass = pass;
+				bestDistance = distance;
+			}
+		}
+
+		if (bestPass == UINT32_MAX)
+			break;
+
+		scheduledAt[bestPass] = static_cast<uint32_t>(mSchedule.size());
+		mSchedule.push_back(bestPass);
+	}
+
+	mCompiledSignature = signature;
+	mCompileCount++;
+
+	LOG_INFO("Frame graph compiled, %u of %u passes scheduled",
+		static_cast<uint32_t>(mSchedule.size()), passCount);
+
+	return true;
+}
+
+bool VulkanFrameGraph::Execute(VkCommandBuffer commandBuffer)
+{
+	if (mCompileCount == 0)
+	{
+		LOG_ERROR("Frame graph is not compiled");
+		return false;
+	}
+
+	for (const auto& resource : mResources)
+	{
+		if (resource.Image == nullptr && resource.Buffer == nullptr)
+		{
+			LOG_ERROR("Frame graph resource %s is not bound", resource.Name.c_str());
+			return false;
+		}
+	}
+
+	mStateTracker.Begin(commandBuffer);
+
+	for (uint32_t pass : mSchedule)
+	{
+		for (const auto& access : mPasses[pass].Accesses)
+		{
+			UseResource(mResources[access.Resource], access.Layout, 
+				access.AccessFlags, access.Stages);
+		}
+
+		mStateTracker.Flush();
+
+		if (mPasses[pass].Execute)
+			mPasses[pass].Execute(commandBuffer);
+	}
+
+	for (const auto& resource : mResources)
+	{
+		if (resource.Output)
+		{
+			UseResource(resource, resource.OutputLayout, 
+				resource.OutputAccess, resource.OutputStages);
+		}
+	}
+
+	mStateTracker.Flush();
+
+	return true;
+}
+
+void VulkanFrameGraph::BuildSignature(std::vector<uint64_t> &signature) const
+{
+	signature.push_back(mResources.size());
+	signature.push_back(mPasses.size());
+
+	for (const auto& resource : mResources)
+		signature.push_back(resource.Output ? 1 : 0);
+
+	for (const auto& pass : mPasses)
+	{
+		signature.push_back(pass.Accesses.size());
+
+		for (const auto& access : pass.Accesses)
+		{
+			signature.push_back((static_cast<uint64_t>(access.Resource) << 1) | (access.Write ? 1 : 0));
+			signature.push_back((static_cast<uint64_t>(access.Layout) << 32) | access.AccessFlags);
+			signature.push_back(access.Stages);
+		}
+	}
+}
+
+void VulkanFrameGraph::BuildDependencies(std::vector<std::vector<uint32_t>> &dependencies) const
+{
+	std::vector<uint32_t> lastWriters(mResources.size(), UINT32_MAX);
+	std::vector<std::vector<uint32_t>> readers(mResources.size());
+
+	dependencies.assign(mPasses.size(), {});
+
+	for (uint32_t pass = 0; pass < static_cast<uint32_t>(mPasses.size()); pass++)
+	{
+		std::vector<uint32_t> &passDependencies = dependencies[pass];
+
+		for (const auto& access : mPasses[pass].Accesses)
+		{
+			if (lastWriters[access.Resource] != UINT32_MAX && lastWriters[access.Resource] != pass)
+				passDependencies.push_back(lastWriters[access.Resource]);
+
+			if (access.Write)
+			{
+				for (uint32_t reader : readers[access.Resource])
+				{
+					if (reader != pass)
+						passDependencies.push_back(reader);
+				}
+			}
+		}
+
+		for (const auto& access : mPasses[pass].Accesses)
+		{
+			if (access.Write)
+			{
+				lastWriters[access.Resource] = pass;
+				readers[access.Resource].clear();
+			}
+			else
+			{
+				readers[access.Resource].push_back(pass);
+			}
+		}
+	}
+}
+
+void VulkanFrameGraph::UseResource(const Resource &resource, VkImageLayout layout,
+	VkAccessFlags access, VkPipelineStageFlags stages)
+{
+	if (resource.Image)
+	{
+		VkImageSubresourceRange range =
+		{
+			resource.AspectFlags,
+			0,
+			VK_REMAINING_MIP_LEVELS,
+			0,
+			VK_REMAINING_ARRAY_LAYERS
+		};
+
+		mStateTracker.UseImage(resource.Image, range, layout, access, stages);
+	}
+	else
+	{
+		mStateTracker.UseBuffer(resource.Buffer, 0, VK_WHOLE_SIZE, access, stages);
+	}
+}
\ No newline at end of file
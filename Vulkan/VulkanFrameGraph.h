@@ -0,0 +1,119 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "VulkanStateTracker.h"
+
+class VulkanFrameGraph
+{
+public:
+
+	typedef std::function<void(VkCommandBuffer commandBuffer)> Callback;
+
+private:
+
+	struct Resource
+	{
+		std::string Name;
+		VkImage Image;
+		VkBuffer Buffer;
+		VkImageAspectFlags AspectFlags;
+		uint32_t MipLevels;
+		uint32_t ArrayLayers;
+		bool Output;
+		VkImageLayout OutputLayout;
+		VkAccessFlags OutputAccess;
+		VkPipelineStageFlags OutputStages;
+	};
+
+	struct Access
+	{
+		uint32_t Resource;
+		bool Write;
+		VkImageLayout Layout;
+		VkAccessFlags AccessFlags;
+		VkPipelineStageFlags Stages;
+	};
+
+	struct Pass
+	{
+		std::string Name;
+		Callback Execute;
+		std::vector<Access> Accesses;
+	};
+
+	std::vector<Resource>				mResources;
+	std::vector<Pass>					mPasses;
+	std::vector<uint32_t>				mSchedule;
+	std::vector<uint64_t>				mCompiledSignature;
+	VulkanStateTracker					mStateTracker;
+	uint32_t							mCompileCount;
+
+public:
+
+	VulkanFrameGraph();
+	~VulkanFrameGraph();
+
+	void SetSynchronization2(PFN_vkCmdPipelineBarrier2KHR cmdPipelineBarrier2);
+
+	uint32_t AddImage(const std::string &name,
+		VkImageAspectFlags aspectFlags,
+		uint32_t mipLevels,
+		uint32_t arrayLayers);
+
+	uint32_t AddBuffer(const std::string &name);
+
+	void BindImage(uint32_t resource,
+		VkImage image,
+		VkImageLayout layout,
+		VkAccessFlags access,
+		VkPipelineStageFlags stages);
+
+	void BindBuffer(uint32_t resource, VkBuffer buffer);
+
+	void SetOutput(uint32_t resource,
+		VkImageLayout layout,
+		VkAccessFlags access,
+		VkPipelineStageFlags stages);
+
+	uint32_t AddPass(const std::string &name, const Callback &callback);
+	void ClearPasses();
+
+	void Read(uint32_t pass, uint32_t resource, 
+		VkImageLayout layout, 
+		VkAccessFlags access, 
+		VkPipelineStageFlags stages);
+
+	void Write(uint32_t pass, uint32_t resource, 
+		VkImageLayout layout, 
+		VkAccessFlags access, 
+		VkPipelineStageFlags stages);
+
+	bool Compile();
+	bool Execute(VkCommandBuffer commandBuffer);
+
+	const std::vector<uint32_t>& GetSchedule() const
+	{
+		return mSchedule;
+	}
+
+	uint32_t GetCompileCount() const
+	{
+		return mCompileCount;
+	}
+
+	const VulkanStateTrackerStats& GetBarrierStats() const
+	{
+		return mStateTracker.GetStats();
+	}
+
+private:
+
+	void BuildSignature(std::vector<uint64_t> &signature) const;
+	void BuildDependencies(std::vector<std::vector<uint32_t>> &dependencies) const;
+	void UseResource(const Resource &resource, VkImageLayout layout, 
+		VkAccessFlags access, VkPipelineStageFlags stages);
+};
\ No newline at end of file
@@ -0,0 +1,84 @@
+#include "VulkanHeadlessBackend.h"
+#include "Logger.h"
+
+VulkanHeadlessBackend::VulkanHeadlessBackend(uint64_t frameLimit)
+	: mWidth(0),
+	mHeight(0),
+	mFrameLimit(frameLimit),
+	mFrameCount(0)
+{
+}
+
+VulkanHeadlessBackend::~VulkanHeadlessBackend()
+{
+}
+
+const char* VulkanHeadlessBackend::GetSurfaceExtensionName() const
+{
+	return VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME;
+}
+
+bool VulkanHeadlessBackend::Create(uint32_t width, uint32_t height, const std::string &title)
+{
+	mWidth = width;
+	mHeight = height;
+	mFrameCount = 0;
+
+	LOG_INFO("Headless presentation %ux%u for %s", width, height, title.c_str());
+
+	return true;
+}
+
+void VulkanHeadlessBackend::Destroy()
+{
+	mWidth = 0;
+	mHeight = 0;
+}
+
+void VulkanHeadlessBackend::Show()
+{
+}
+
+bool VulkanHeadlessBackend::ProcessEvents()
+{
+	return mFrameLimit == 0 || mFrameCount++ < mFrameLimit;
+}
+
+bool VulkanHeadlessBackend::TakeResize()
+{
+	return false;
+}
+
+bool VulkanHeadlessBackend::CreateSurface(VkInstance instance, VkSurfaceKHR *surface)
+{
+	PFN_vkCreateHeadlessSurfaceEXT createHeadlessSurface = 
+		reinterpret_cast<PFN_vkCreateHeadlessSurfaceEXT>(
+			vkGetInstanceProcAddr(instance, "vkCreateHeadlessSurfaceEXT"));
+
+	if (createHeadlessSurface == nullptr)
+	{
+		LOG_ERROR("vkCreateHeadlessSurfaceEXT is unavailable");
+		return false;
+	}
+
+	VkHeadlessSurfaceCreateInfoEXT surfaceInfo =
+	{
+		VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT,
+		nullptr,
+		0
+	};
+
+	VkResult result = createHeadlessSurface(
+		instance,
+		&surfaceInfo,
+		nullptr,
+		surface);
+
+	if (result != VK_SUCCESS || *surface == nullptr)
+	{
+		LOG_ERROR("Unable to create headless surface");
+		return false;
+	}
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "VulkanPresentationBackend.h"
+
+class VulkanHeadlessBackend : public VulkanPresentationBackend
+{
+private:
+
+	uint32_t			mWidth;
+	uint32_t			mHeight;
+	uint64_t			mFrameLimit;
+	uint64_t			mFrameCount;
+
+public:
+
+	VulkanHeadlessBackend(uint64_t frameLimit = 0);
+	~VulkanHeadlessBackend();
+
+	const char* GetSurfaceExtensionName() const override;
+
+	uint32_t GetWidth() const override
+	{
+		return mWidth;
+	}
+
+	uint32_t GetHeight() const override
+	{
+		return mHeight;
+	}
+
+	bool Create(uint32_t width, uint32_t height, const std::string &title) override;
+	void Destroy() override;
+	void Show() override;
+	bool ProcessEvents() override;
+	bool TakeResize() override;
+
+	bool CreateSurface(VkInstance instance, VkSurfaceKHR *surface) override;
+};
\ No newline at end of file
@@ -0,0 +1,845 @@
+#include "VulkanMemoryAllocator.h"
+#include "Logger.h"
+#include <cinttypes>
+#include <algorithm>
+
+struct MemoryUsageFlags
+{
+	VkMemoryPropertyFlags Required;
+	VkMemoryPropertyFlags Preferred;
+	VkMemoryPropertyFlags Disallowed;
+	VkMemoryPropertyFlags Excluded;
+};
+
+static const VkMemoryPropertyFlags ExcludedMemoryFlags =
+	VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT |
+	VK_MEMORY_PROPERTY_PROTECTED_BIT;
+
+static MemoryUsageFlags GetMemoryUsageFlags(VulkanMemoryUsage usage)
+{
+	switch (usage)
+	{
+	case VulkanMemoryUsage::Upload:
+		return {
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+			VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			VK_MEMORY_PROPERTY_HOST_CACHED_BIT | VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+			ExcludedMemoryFlags
+		};
+
+	case VulkanMemoryUsage::Readback:
+		return {
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+			VK_MEMORY_PROPERTY_HOST_CACHED_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+			ExcludedMemoryFlags
+		};
+
+	case VulkanMemoryUsage::Dynamic:
+		return {
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			VK_MEMORY_PROPERTY_HOST_CACHED_BIT,
+			ExcludedMemoryFlags
+		};
+
+	case VulkanMemoryUsage::GpuLazilyAllocated:
+		return {
+			0,
+			VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT | VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT,
+			VK_MEMORY_PROPERTY_PROTECTED_BIT
+		};
+
+	case VulkanMemoryUsage::GpuOnly:
+	default:
+		return {
+			0,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT,
+			ExcludedMemoryFlags
+		};
+	}
+}
+
+static uint32_t CountBits(uint32_t value)
+{
+	uint32_t count = 0;
+
+	for (; value != 0; value &= value - 1)
+		count++;
+
+	return count;
+}
+
+static VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment)
+{
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static bool IsOnSamePage(VkDeviceSize offsetA, VkDeviceSize sizeA,
+	VkDeviceSize offsetB, VkDeviceSize pageSize)
+{
+	VkDeviceSize endPageA = (offsetA + sizeA - 1) & ~(pageSize - 1);
+	VkDeviceSize startPageB = offsetB & ~(pageSize - 1);
+
+	return endPageA == startPageB;
+}
+
+static bool IsGranularityConflict(VulkanSuballocationType typeA, VulkanSuballocationType typeB)
+{
+	if (typeA == VulkanSuballocationType::Free || typeB == VulkanSuballocationType::Free)
+		return false;
+
+	return typeA != typeB;
+}
+
+VulkanMemoryBlock::VulkanMemoryBlock(VkDevice device, VkDeviceMemory memory,
+	uint32_t memoryTypeIndex, VkDeviceSize size, bool coherent,
+	bool dedicated)
+	: mDevice(device),
+	mMemory(memory),
+	mMemoryTypeIndex(memoryTypeIndex),
+	mSize(size),
+	mFreeSize(size),
+	mAllocationCount(0),
+	mMappedData(nullptr),
+	mCoherent(coherent),
+	mDedicated(dedicated)
+{
+	mSuballocations[0] = { size, VulkanSuballocationType::Free };
+	InsertFreeRange(0, size);
+}
+
+VulkanMemoryBlock::~VulkanMemoryBlock()
+{
+	if (mMappedData)
+		vkUnmapMemory(mDevice, mMemory);
+
+	if (mMemory)
+		vkFreeMemory(mDevice, mMemory, nullptr);
+
+	mMappedData = nullptr;
+	mMemory = nullptr;
+}
+
+bool VulkanMemoryBlock::Allocate(VkDeviceSize size,
+	VkDeviceSize alignment,
+	VkDeviceSize granularity,
+	VulkanSuballocationType type,
+	VkDeviceSize *offset)
+{
+	if (size > mFreeSize)
+		return false;
+
+	for (auto freeRange = mFreeRanges.lower_bound(size); freeRange != mFreeRanges.end(); ++freeRange)
+	{
+		VkDeviceSize freeSize = freeRange->first;
+		VkDeviceSize freeOffset = freeRange->second;
+		VkDeviceSize allocationOffset = AlignUp(freeOffset, alignment);
+
+		auto current = mSuballocations.find(freeOffset);
+
+		if (granularity > 1)
+		{
+			auto previous = current;
+			while (previous != mSuballocations.begin())
+			{
+				--previous;
+
+				if (!IsOnSamePage(previous->first, previous->second.Size, allocationOffset, granularity))
+					break;
+
+				if (IsGranularityConflict(previous->second.Type, type))
+				{
+					allocationOffset = AlignUp(allocationOffset, granularity);
+					break;
+				}
+			}
+		}
+
+		if (allocationOffset + size > freeOffset + freeSize)
+			continue;
+
+		if (granularity > 1)
+		{
+			bool conflict = false;
+
+			for (auto next = std::next(current); next != mSuballocations.end(); ++next)
+			{
+				if (!IsOnSamePage(allocationOffset, size, next->first, granularity))
+					break;
+
+				if (IsGranularityConflict(type, next->second.Type))
+				{
+					conflict = true;
+					break;
+				}
+			}
+
+			if (conflict)
+				continue;
+		}
+
+		VkDeviceSize padding = allocationOffset - freeOffset;
+		VkDeviceSize remaining = freeOffset + freeSize - (allocationOffset + size);
+
+		mFreeRanges.erase(freeRange);
+		mSuballocations.erase(current);
+
+		if (padding > 0)
+		{
+			mSuballocations[freeOffset] = { padding, VulkanSuballocationType::Free };
+			InsertFreeRange(freeOffset, padding);
+		}
+
+		mSuballocations[allocationOffset] = { size, type };
+
+		if (remaining > 0)
+		{
+			mSuballocations[allocationOffset + size] = { remaining, VulkanSuballocationType::Free };
+			InsertFreeRange(allocationOffset + size, remaining);
+		}
+
+		mFreeSize -= size;
+		mAllocationCount++;
+		*offset = allocationOffset;
+
+		return true;
+	}
+
+	return false;
+}
+
+void VulkanMemoryBlock::Free(VkDeviceSize offset)
+{
+	auto current = mSuballocations.find(offset);
+
+	if (current == mSuballocations.end() ||
+		current->second.Type == VulkanSuballocationType::Free)
+	{
+		LOG_ERROR("Unable to free suballocation at offset %" PRIu64, offset);
+		return;
+	}
+
+	mFreeSize += current->second.Size;
+	mAllocationCount--;
+	current->second.Type = VulkanSuballocationType::Free;
+
+	auto next = std::next(current);
+	if (next != mSuballocations.end() && next->second.Type == VulkanSuballocationType::Free)
+	{
+		EraseFreeRange(next->first, next->second.Size);
+		current->second.Size += next->second.Size;
+		mSuballocations.erase(next);
+	}
+
+	if (current != mSuballocations.begin())
+	{
+		auto previous = std::prev(current);
+		if (previous->second.Type == VulkanSuballocationType::Free)
+		{
+			EraseFreeRange(previous->first, previous->second.Size);
+			previous->second.Size += current->second.Size;
+			mSuballocations.erase(current);
+			current = previous;
+		}
+	}
+
+	InsertFreeRange(current->first, current->second.Size);
+}
+
+bool VulkanMemoryBlock::Map(void **data)
+{
+	if (mMappedData == nullptr)
+	{
+		VkResult result = vkMapMemory(
+			mDevice,
+			mMemory,
+			0,
+			VK_WHOLE_SIZE,
+			0,
+			&mMappedData
+		);
+
+		if (result != VK_SUCCESS)
+		{
+			LOG_ERROR("Unable to Map memory block");
+			mMappedData = nullptr;
+			return false;
+		}
+	}
+
+	*data = mMappedData;
+	return true;
+}
+
+bool VulkanMemoryBlock::AddFlushRange(VkDeviceSize offset, VkDeviceSize size, VkDeviceSize atomSize)
+{
+	return AddRange(mFlushRanges, offset, size, atomSize);
+}
+
+bool VulkanMemoryBlock::AddInvalidateRange(VkDeviceSize offset, VkDeviceSize size, VkDeviceSize atomSize)
+{
+	return AddRange(mInvalidateRanges, offset, size, atomSize);
+}
+
+void VulkanMemoryBlock::TakeFlushRanges(std::vector<VkMappedMemoryRange> &ranges)
+{
+	TakeRanges(mFlushRanges, ranges);
+}
+
+void VulkanMemoryBlock::TakeInvalidateRanges(std::vector<VkMappedMemoryRange> &ranges)
+{
+	TakeRanges(mInvalidateRanges, ranges);
+}
+
+bool VulkanMemoryBlock::AddRange(std::map<VkDeviceSize, VkDeviceSize> &ranges,
+	VkDeviceSize offset, VkDeviceSize size, VkDeviceSize atomSize)
+{
+	bool wasEmpty = ranges.empty();
+
+	VkDeviceSize start = offset / atomSize * atomSize;
+	VkDeviceSize end = AlignUp(offset + size, atomSize);
+
+	if (end > mSize)
+		end = mSize;
+
+	auto next = ranges.upper_bound(start);
+
+	if (next != ranges.begin())
+	{
+		auto previous = std::prev(next);
+
+		if (previous->second >= start)
+		{
+			start = previous->first;
+			end = previous->second > end ? previous->second : end;
+			ranges.erase(previous);
+		}
+	}
+
+	while (next != ranges.end() && next->first <= end)
+	{
+		end = next->second > end ? next->second : end;
+		next = ranges.erase(next);
+	}
+
+	ranges[start] = end;
+
+	return wasEmpty;
+}
+
+void VulkanMemoryBlock::TakeRanges(std::map<VkDeviceSize, VkDeviceSize> &ranges,
+	std::vector<VkMappedMemoryRange> &mappedRanges)
+{
+	for (const auto& range : ranges)
+	{
+		mappedRanges.push_back({
+			VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
+			nullptr,
+			mMemory,
+			range.first,
+			range.second - range.first
+		});
+	}
+
+	ranges.clear();
+}
+
+void VulkanMemoryBlock::InsertFreeRange(VkDeviceSize offset, VkDeviceSize size)
+{
+	mFreeRanges.insert({ size, offset });
+}
+
+void VulkanMemoryBlock::EraseFreeRange(VkDeviceSize offset, VkDeviceSize size)
+{
+	auto range = mFreeRanges.equal_range(size);
+
+	for (auto freeRange = range.first; freeRange != range.second; ++freeRange)
+	{
+		if (freeRange->second == offset)
+		{
+			mFreeRanges.erase(freeRange);
+			return;
+		}
+	}
+}
+
+VulkanMemoryAllocator::VulkanMemoryAllocator()
+	: mDevice(nullptr),
+	mBufferImageGranularity(1),
+	mNonCoherentAtomSize(1),
+	mBlockSize(DefaultBlockSize),
+	mDedicatedAllocationEnabled(false)
+{
+	std::fill(std::begin(mHeapUsage), std::end(mHeapUsage), 0);
+}
+
+VulkanMemoryAllocator::~VulkanMemoryAllocator()
+{
+	Destroy();
+}
+
+bool VulkanMemoryAllocator::Initialize(VkDevice device,
+	const VkPhysicalDeviceMemoryProperties &memoryProperties,
+	VkDeviceSize bufferImageGranularity,
+	VkDeviceSize nonCoherentAtomSize,
+	bool dedicatedAllocationEnabled,
+	VkDeviceSize blockSize)
+{
+	if (device == nullptr || blockSize == 0)
+	{
+		LOG_ERROR("Invalid memory allocator parameters");
+		return false;
+	}
+
+	mDevice = device;
+	mMemoryProperties = memoryProperties;
+	mBufferImageGranularity = bufferImageGranularity > 0 ? bufferImageGranularity : 1;
+	mNonCoherentAtomSize = nonCoherentAtomSize > 0 ? nonCoherentAtomSize : 1;
+	mBlockSize = blockSize;
+	mDedicatedAllocationEnabled = dedicatedAllocationEnabled;
+
+	std::fill(std::begin(mHeapUsage), std::end(mHeapUsage), 0);
+
+	return true;
+}
+
+void VulkanMemoryAllocator::Destroy()
+{
+	mFlushBlocks.clear();
+	mInvalidateBlocks.clear();
+
+	for (auto& blocks : mBlocks)
+		blocks.clear();
+
+	std::fill(std::begin(mHeapUsage), std::end(mHeapUsage), 0);
+	mDevice = nullptr;
+}
+
+bool VulkanMemoryAllocator::Allocate(const VkMemoryRequirements &memoryRequirements,
+	VulkanMemoryUsage usage,
+	VulkanSuballocationType type,
+	VulkanAllocation *allocation)
+{
+	std::vector<uint32_t> memoryTypes;
+	*allocation = { nullptr, 0, 0 };
+
+	GetMemoryTypeCandidates(memoryRequirements.memoryTypeBits, usage,
+		memoryRequirements.size, memoryTypes);
+
+	if (memoryTypes.size() == 0)
+	{
+		LOG_ERROR("No memory type matches the requested usage");
+		return false;
+	}
+
+	for (uint32_t memoryType : memoryTypes)
+	{
+		if (AllocateFromType(memoryType, memoryRequirements, type, allocation))
+			return true;
+
+		LOG_WARN("Memory type %d exhausted, falling back", memoryType);
+	}
+
+	LOG_ERROR("Unable to allocate %" PRIu64 " bytes of device memory", memoryRequirements.size);
+	return false;
+}
+
+bool VulkanMemoryAllocator::AllocateDedicated(const VkMemoryRequirements &memoryRequirements,
+	VulkanMemoryUsage usage,
+	VkBuffer buffer,
+	VkImage image,
+	VulkanAllocation *allocation)
+{
+	std::vector<uint32_t> memoryTypes;
+	*allocation = { nullptr, 0, 0 };
+
+	VkMemoryDedicatedAllocateInfoKHR dedicatedInfo =
+	{
+		VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO_KHR,
+		nullptr,
+		image,
+		buffer
+	};
+
+	GetMemoryTypeCandidates(memoryRequirements.memoryTypeBits, usage,
+		memoryRequirements.size, memoryTypes);
+
+	for (uint32_t memoryType : memoryTypes)
+	{
+		VulkanMemoryBlock *block = CreateBlock(memoryType, memoryRequirements.size,
+			true, mDedicatedAllocationEnabled && (buffer || image) ? &dedicatedInfo : nullptr);
+
+		VkDeviceSize offset = 0;
+
+		if (block && block->Allocate(memoryRequirements.size, 1, 1,
+			VulkanSuballocationType::Optimal, &offset))
+		{
+			*allocation = { block, offset, memoryRequirements.size };
+			return true;
+		}
+
+		LOG_WARN("Memory type %d exhausted, falling back", memoryType);
+	}
+
+	LOG_ERROR("Unable to allocate %" PRIu64 " bytes of dedicated memory", memoryRequirements.size);
+	return false;
+}
+
+void VulkanMemoryAllocator::Free(const VulkanAllocation &allocation)
+{
+	VulkanMemoryBlock *block = allocation.Block;
+
+	if (block == nullptr)
+		return;
+
+	block->Free(allocation.Offset);
+
+	if (block->IsDedicated())
+	{
+		DestroyBlock(block->GetMemoryTypeIndex(), block);
+		return;
+	}
+
+	if (!block->IsEmpty())
+		return;
+
+	auto& blocks = mBlocks[block->GetMemoryTypeIndex()];
+	uint32_t emptyBlockCount = 0;
+
+	for (const auto& typeBlock : blocks)
+	{
+		if (!typeBlock->IsDedicated() && typeBlock->IsEmpty())
+			emptyBlockCount++;
+	}
+
+	if (emptyBlockCount < 2 && block->GetSize() <= mBlockSize)
+		return;
+
+	DestroyBlock(block->GetMemoryTypeIndex(), block);
+}
+
+bool VulkanMemoryAllocator::Map(const VulkanAllocation &allocation, void **data)
+{
+	void *blockData = nullptr;
+
+	if (allocation.Block == nullptr || !allocation.Block->Map(&blockData))
+		return false;
+
+	*data = static_cast<uint8_t*>(blockData) + allocation.Offset;
+	return true;
+}
+
+void VulkanMemoryAllocator::AddFlushRange(const VulkanAllocation &allocation,
+	VkDeviceSize offset, VkDeviceSize size)
+{
+	VulkanMemoryBlock *block = allocation.Block;
+
+	if (block == nullptr || block->IsCoherent())
+		return;
+
+	if (size == VK_WHOLE_SIZE)
+		size = allocation.Size - offset;
+
+	if (block->AddFlushRange(allocation.Offset + offset, size, mNonCoherentAtomSize))
+		mFlushBlocks.push_back(block);
+}
+
+void VulkanMemoryAllocator::AddInvalidateRange(const VulkanAllocation &allocation,
+	VkDeviceSize offset, VkDeviceSize size)
+{
+	VulkanMemoryBlock *block = allocation.Block;
+
+	if (block == nullptr || block->IsCoherent())
+		return;
+
+	if (size == VK_WHOLE_SIZE)
+		size = allocation.Size - offset;
+
+	if (block->AddInvalidateRange(allocation.Offset + offset, size, mNonCoherentAtomSize))
+		mInvalidateBlocks.push_back(block);
+}
+
+bool VulkanMemoryAllocator::FlushMappedRanges()
+{
+	if (mFlushBlocks.size() == 0)
+		return true;
+
+	mMappedRanges.clear();
+
+	for (auto block : mFlushBlocks)
+		block->TakeFlushRanges(mMappedRanges);
+
+	mFlushBlocks.clear();
+
+	VkResult result = vkFlushMappedMemoryRanges(
+		mDevice,
+		static_cast<uint32_t>(mMappedRanges.size()),
+		&mMappedRanges[0]
+	);
+
+	if (result != VK_SUCCESS)
+	{
+		LOG_ERROR("Unable to flush mapped memory ranges");
+		return false;
+	}
+
+	return true;
+}
+
+bool VulkanMemoryAllocator::InvalidateMappedRanges()
+{
+	if (mInvalidateBlocks.size() == 0)
+		return true;
+
+	mMappedRanges.clear();
+
+	for (auto block : mInvalidateBlocks)
+		block->TakeInvalidateRanges(mMappedRanges);
+
+	mInvalidateBlocks.clear();
+
+	VkResult result = vkInvalidateMappedMemoryRanges(
+		mDevice,
+		static_cast<uint32_t>(mMappedRanges.size()),
+		&mMappedRanges[0]
+	);
+
+	if (result != VK_SUCCESS)
+	{
+		LOG_ERROR("Unable to invalidate mapped memory ranges");
+		return false;
+	}
+
+	return true;
+}
+
+VkMemoryPropertyFlags VulkanMemoryAllocator::GetMemoryPropertyFlags(const VulkanAllocation &allocation) const
+{
+	if (allocation.Block == nullptr)
+		return 0;
+
+	return mMemoryProperties.memoryTypes[allocation.Block->GetMemoryTypeIndex()].propertyFlags;
+}
+
+static void AddStatInfo(VulkanMemoryStatInfo &info, const VulkanMemoryStatInfo &other)
+{
+	info.BlockCount += other.BlockCount;
+	info.AllocationCount += other.AllocationCount;
+	info.BlockBytes += other.BlockBytes;
+	info.AllocationBytes += other.AllocationBytes;
+	info.LargestFreeRange = std::max(info.LargestFreeRange, other.LargestFreeRange);
+}
+
+void VulkanMemoryAllocator::GetStats(VulkanMemoryStats *stats) const
+{
+	*stats = {};
+
+	for (uint32_t memoryType = 0; memoryType < mMemoryProperties.memoryTypeCount; memoryType++)
+	{
+		VulkanMemoryStatInfo &info = stats->MemoryTypes[memoryType];
+
+		for (const auto& block : mBlocks[memoryType])
+		{
+			info.BlockCount++;
+			info.AllocationCount += block->GetAllocationCount();
+			info.BlockBytes += block->GetSize();
+			info.AllocationBytes += block->GetSize() - block->GetFreeSize();
+			info.LargestFreeRange = std::max(info.LargestFreeRange, block->GetLargestFreeRange());
+		}
+
+		AddStatInfo(stats->MemoryHeaps[mMemoryProperties.memoryTypes[memoryType].heapIndex], info);
+		AddStatInfo(stats->Total, info);
+	}
+
+	for (uint32_t heapIndex = 0; heapIndex < mMemoryProperties.memoryHeapCount; heapIndex++)
+	{
+		stats->HeapBudget[heapIndex] = mMemoryProperties.memoryHeaps[heapIndex].size;
+		stats->HeapUsage[heapIndex] = mHeapUsage[heapIndex];
+	}
+}
+
+bool VulkanMemoryAllocator::FindMemoryTypeIndex(uint32_t memoryTypeBits,
+	VulkanMemoryUsage usage,
+	uint32_t *memoryTypeIndex) const
+{
+	std::vector<uint32_t> memoryTypes;
+
+	GetMemoryTypeCandidates(memoryTypeBits, usage, 0, memoryTypes);
+
+	if (memoryTypes.size() == 0)
+		return false;
+
+	*memoryTypeIndex = memoryTypes[0];
+	return true;
+}
+
+void VulkanMemoryAllocator::GetMemoryTypeCandidates(uint32_t memoryTypeBits,
+	VulkanMemoryUsage usage,
+	VkDeviceSize size,
+	std::vector<uint32_t> &memoryTypes) const
+{
+	struct Candidate
+	{
+		uint32_t MemoryType;
+		int32_t Score;
+		bool Exhausted;
+		VkDeviceSize Remaining;
+	};
+
+	MemoryUsageFlags usageFlags = GetMemoryUsageFlags(usage);
+	std::vector<Candidate> candidates;
+
+	for (uint32_t memoryType = 0; memoryType < mMemoryProperties.memoryTypeCount; memoryType++)
+	{
+		if (!(memoryTypeBits & (1 << memoryType)))
+			continue;
+
+		VkMemoryPropertyFlags flags = mMemoryProperties.memoryTypes[memoryType].propertyFlags;
+
+		if ((flags & usageFlags.Required) != usageFlags.Required || (flags & usageFlags.Excluded))
+			continue;
+
+		VkDeviceSize remaining = GetHeapRemaining(mMemoryProperties.memoryTypes[memoryType].heapIndex);
+
+		int32_t score =
+			2 * static_cast<int32_t>(CountBits(flags & usageFlags.Preferred)) -
+			3 * static_cast<int32_t>(CountBits(flags & usageFlags.Disallowed));
+
+		candidates.push_back({ memoryType, score, remaining < size, remaining });
+	}
+
+	std::stable_sort(candidates.begin(), candidates.end(),
+		[](const Candidate &a, const Candidate &b)
+		{
+			if (a.Exhausted != b.Exhausted)
+				return !a.Exhausted;
+
+			if (a.Score != b.Score)
+				return a.Score > b.Score;
+
+			return a.Remaining > b.Remaining;
+		});
+
+	memoryTypes.clear();
+
+	for (const auto& candidate : candidates)
+		memoryTypes.push_back(candidate.MemoryType);
+}
+
+VkDeviceSize VulkanMemoryAllocator::GetHeapRemaining(uint32_t heapIndex) const
+{
+	VkDeviceSize heapSize = mMemoryProperties.memoryHeaps[heapIndex].size;
+
+	if (mHeapUsage[heapIndex] >= heapSize)
+		return 0;
+
+	return heapSize - mHeapUsage[heapIndex];
+}
+
+bool VulkanMemoryAllocator::AllocateFromType(uint32_t memoryTypeIndex,
+	const VkMemoryRequirements &memoryRequirements,
+	VulkanSuballocationType type,
+	VulkanAllocation *allocation)
+{
+	VkDeviceSize offset = 0;
+	VkDeviceSize alignment = memoryRequirements.alignment > 0 ? memoryRequirements.alignment : 1;
+
+	for (const auto& block : mBlocks[memoryTypeIndex])
+	{
+		if (block->IsDedicated())
+			continue;
+
+		if (block->Allocate(memoryRequirements.size, alignment,
+			mBufferImageGranularity, type, &offset))
+		{
+			*allocation = { block.get(), offset, memoryRequirements.size };
+			return true;
+		}
+	}
+
+	VkDeviceSize blockSize = GetPreferredBlockSize(memoryTypeIndex);
+	if (memoryRequirements.size > blockSize)
+		blockSize = memoryRequirements.size;
+
+	VulkanMemoryBlock *block = CreateBlock(memoryTypeIndex, blockSize);
+
+	if (block == nullptr || !block->Allocate(memoryRequirements.size, alignment,
+		mBufferImageGranularity, type, &offset))
+	{
+		return false;
+	}
+
+	*allocation = { block, offset, memoryRequirements.size };
+	return true;
+}
+
+VulkanMemoryBlock* VulkanMemoryAllocator::CreateBlock(uint32_t memoryTypeIndex, VkDeviceSize size,
+	bool dedicated, const void *next)
+{
+	VkDeviceMemory memory = nullptr;
+
+	VkMemoryAllocateInfo allocateInfo =
+	{
+		VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+		next,
+		size,
+		memoryTypeIndex
+	};
+
+	VkResult result = vkAllocateMemory(
+		mDevice,
+		&allocateInfo,
+		nullptr,
+		&memory
+	);
+
+	if (result != VK_SUCCESS || memory == nullptr)
+	{
+		LOG_WARN("Unable to allocate memory block of type %d", memoryTypeIndex);
+		return nullptr;
+	}
+
+	bool coherent = (mMemoryProperties.memoryTypes[memoryTypeIndex].propertyFlags &
+		VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+
+	mBlocks[memoryTypeIndex].emplace_back(
+		new VulkanMemoryBlock(mDevice, memory, memoryTypeIndex, size, coherent, dedicated));
+
+	mHeapUsage[mMemoryProperties.memoryTypes[memoryTypeIndex].heapIndex] += size;
+
+	return mBlocks[memoryTypeIndex].back().get();
+}
+
+void VulkanMemoryAllocator::DestroyBlock(uint32_t memoryTypeIndex, VulkanMemoryBlock *block)
+{
+	auto& blocks = mBlocks[memoryTypeIndex];
+
+	for (auto typeBlock = blocks.begin(); typeBlock != blocks.end(); ++typeBlock)
+	{
+		if (typeBlock->get() == block)
+		{
+			mFlushBlocks.erase(std::remove(mFlushBlocks.begin(), mFlushBlocks.end(), block), 
+				mFlushBlocks.end());
+			mInvalidateBlocks.erase(std::remove(mInvalidateBlocks.begin(), mInvalidateBlocks.end(), block),
+				mInvalidateBlocks.end());
+
+			mHeapUsage[mMemoryProperties.memoryTypes[memoryTypeIndex].heapIndex] -= block->GetSize();
+			blocks.erase(typeBlock);
+			break;
+		}
+	}
+}
+
+VkDeviceSize VulkanMemoryAllocator::GetPreferredBlockSize(uint32_t memoryTypeIndex) const
+{
+	uint32_t heapIndex = mMemoryProperties.memoryTypes[memoryTypeIndex].heapIndex;
+	VkDeviceSize heapSize = mMemoryProperties.memoryHeaps[heapIndex].size;
+
+	if (heapSize / 8 < mBlockSize)
+		return AlignUp(heapSize / 8, 1024 * 1024);
+
+	return mBlockSize;
+}
\ No newline at end of file
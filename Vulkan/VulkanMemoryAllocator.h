@@ -0,0 +1,237 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+enum class VulkanMemoryUsage
+{
+	GpuOnly,
+	Upload,
+	Readback,
+	Dynamic,
+	GpuLazilyAllocated
+};
+
+enum class VulkanSuballocationType
+{
+	Free,
+	Linear,
+	Optimal
+};
+
+class VulkanMemoryBlock
+{
+private:
+
+	struct Suballocation
+	{
+		VkDeviceSize Size;
+		VulkanSuballocationType Type;
+	};
+
+	VkDevice											mDevice;
+	VkDeviceMemory										mMemory;
+	uint32_t											mMemoryTypeIndex;
+	VkDeviceSize										mSize;
+	VkDeviceSize										mFreeSize;
+	uint32_t											mAllocationCount;
+	void												*mMappedData;
+	bool												mCoherent;
+	bool												mDedicated;
+
+	std::map<VkDeviceSize, Suballocation>				mSuballocations;
+	std::multimap<VkDeviceSize, VkDeviceSize>			mFreeRanges;
+	std::map<VkDeviceSize, VkDeviceSize>				mFlushRanges;
+	std::map<VkDeviceSize, VkDeviceSize>				mInvalidateRanges;
+
+public:
+
+	VulkanMemoryBlock(VkDevice device, VkDeviceMemory memory,
+		uint32_t memoryTypeIndex, VkDeviceSize size, bool coherent,
+		bool dedicated);
+	~VulkanMemoryBlock();
+
+	VkDeviceMemory GetMemory() const
+	{
+		return mMemory;
+	}
+
+	uint32_t GetMemoryTypeIndex() const
+	{
+		return mMemoryTypeIndex;
+	}
+
+	VkDeviceSize GetSize() const
+	{
+		return mSize;
+	}
+
+	VkDeviceSize GetFreeSize() const
+	{
+		return mFreeSize;
+	}
+
+	uint32_t GetAllocationCount() const
+	{
+		return mAllocationCount;
+	}
+
+	VkDeviceSize GetLargestFreeRange() const
+	{
+		return mFreeRanges.empty() ? 0 : mFreeRanges.rbegin()->first;
+	}
+
+	bool IsEmpty() const
+	{
+		return mFreeSize == mSize;
+	}
+
+	bool IsCoherent() const
+	{
+		return mCoherent;
+	}
+
+	bool IsDedicated() const
+	{
+		return mDedicated;
+	}
+
+	bool Allocate(VkDeviceSize size,
+		VkDeviceSize alignment,
+		VkDeviceSize granularity,
+		VulkanSuballocationType type,
+		VkDeviceSize *offset);
+
+	void Free(VkDeviceSize offset);
+	bool Map(void **data);
+
+	bool AddFlushRange(VkDeviceSize offset, VkDeviceSize size, VkDeviceSize atomSize);
+	bool AddInvalidateRange(VkDeviceSize offset, VkDeviceSize size, VkDeviceSize atomSize);
+
+	void TakeFlushRanges(std::vector<VkMappedMemoryRange> &ranges);
+	void TakeInvalidateRanges(std::vector<VkMappedMemoryRange> &ranges);
+
+private:
+
+	bool AddRange(std::map<VkDeviceSize, VkDeviceSize> &ranges, 
+		VkDeviceSize offset, VkDeviceSize size, VkDeviceSize atomSize);
+
+	void TakeRanges(std::map<VkDeviceSize, VkDeviceSize> &ranges, 
+		std::vector<VkMappedMemoryRange> &mappedRanges);
+
+	void InsertFreeRange(VkDeviceSize offset, VkDeviceSize size);
+	void EraseFreeRange(VkDeviceSize offset, VkDeviceSize size);
+};
+
+struct VulkanAllocation
+{
+	VulkanMemoryBlock *Block;
+	VkDeviceSize Offset;
+	VkDeviceSize Size;
+};
+
+struct VulkanMemoryStatInfo
+{
+	uint32_t BlockCount;
+	uint32_t AllocationCount;
+	VkDeviceSize BlockBytes;
+	VkDeviceSize AllocationBytes;
+	VkDeviceSize LargestFreeRange;
+};
+
+struct VulkanMemoryStats
+{
+	VulkanMemoryStatInfo MemoryTypes[VK_MAX_MEMORY_TYPES];
+	VulkanMemoryStatInfo MemoryHeaps[VK_MAX_MEMORY_HEAPS];
+	VulkanMemoryStatInfo Total;
+	VkDeviceSize HeapBudget[VK_MAX_MEMORY_HEAPS];
+	VkDeviceSize HeapUsage[VK_MAX_MEMORY_HEAPS];
+	bool BudgetAvailable;
+};
+
+class VulkanMemoryAllocator
+{
+public:
+
+	static const VkDeviceSize DefaultBlockSize = 64ull * 1024 * 1024;
+
+private:
+
+	VkDevice											mDevice;
+	VkPhysicalDeviceMemoryProperties					mMemoryProperties;
+	VkDeviceSize										mBufferImageGranularity;
+	VkDeviceSize										mNonCoherentAtomSize;
+	VkDeviceSize										mBlockSize;
+	bool												mDedicatedAllocationEnabled;
+	VkDeviceSize										mHeapUsage[VK_MAX_MEMORY_HEAPS];
+
+	std::vector<std::unique_ptr<VulkanMemoryBlock>>		mBlocks[VK_MAX_MEMORY_TYPES];
+	std::vector<VulkanMemoryBlock*>						mFlushBlocks;
+	std::vector<VulkanMemoryBlock*>						mInvalidateBlocks;
+	std::vector<VkMappedMemoryRange>					mMappedRanges;
+
+public:
+
+	VulkanMemoryAllocator();
+	~VulkanMemoryAllocator();
+
+	bool Initialize(VkDevice device,
+		const VkPhysicalDeviceMemoryProperties &memoryProperties,
+		VkDeviceSize bufferImageGranularity,
+		VkDeviceSize nonCoherentAtomSize,
+		bool dedicatedAllocationEnabled,
+		VkDeviceSize blockSize = DefaultBlockSize);
+
+	void Destroy();
+
+	bool Allocate(const VkMemoryRequirements &memoryRequirements,
+		VulkanMemoryUsage usage,
+		VulkanSuballocationType type,
+		VulkanAllocation *allocation);
+
+	bool AllocateDedicated(const VkMemoryRequirements &memoryRequirements,
+		VulkanMemoryUsage usage,
+		VkBuffer buffer,
+		VkImage image,
+		VulkanAllocation *allocation);
+
+	void Free(const VulkanAllocation &allocation);
+	bool Map(const VulkanAllocation &allocation, void **data);
+
+	void AddFlushRange(const VulkanAllocation &allocation, 
+		VkDeviceSize offset, VkDeviceSize size);
+
+	void AddInvalidateRange(const VulkanAllocation &allocation, 
+		VkDeviceSize offset, VkDeviceSize size);
+
+	bool FlushMappedRanges();
+	bool InvalidateMappedRanges();
+
+	VkMemoryPropertyFlags GetMemoryPropertyFlags(const VulkanAllocation &allocation) const;
+	void GetStats(VulkanMemoryStats *stats) const;
+
+	bool FindMemoryTypeIndex(uint32_t memoryTypeBits,
+		VulkanMemoryUsage usage,
+		uint32_t *memoryTypeIndex) const;
+
+private:
+
+	void GetMemoryTypeCandidates(uint32_t memoryTypeBits,
+		VulkanMemoryUsage usage,
+		VkDeviceSize size,
+		std::vector<uint32_t> &memoryTypes) const;
+
+	VkDeviceSize GetHeapRemaining(uint32_t heapIndex) const;
+	void DestroyBlock(uint32_t memoryTypeIndex, VulkanMemoryBlock *block);
+
+	bool AllocateFromType(uint32_t memoryTypeIndex,
+		const VkMemoryRequirements &memoryRequirements,
+		VulkanSuballocationType type,
+		VulkanAllocation *allocation);
+
+	VulkanMemoryBlock* CreateBlock(uint32_t memoryTypeIndex, VkDeviceSize size,
+		bool dedicated = false, const void *next = nullptr);
+	VkDeviceSize GetPreferredBlockSize(uint32_t memoryTypeIndex) const;
+};
\ No newline at end of file
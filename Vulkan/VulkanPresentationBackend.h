@@ -0,0 +1,24 @@
+#pragma once
+
+#include <string>
+#include <vulkan/vulkan.h>
+
+class VulkanPresentationBackend
+{
+public:
+
+	virtual ~VulkanPresentationBackend() {}
+
+	virtual const char* GetSurfaceExtensionName() const = 0;
+
+	virtual uint32_t GetWidth() const = 0;
+	virtual uint32_t GetHeight() const = 0;
+
+	virtual bool Create(uint32_t width, uint32_t height, const std::string &title) = 0;
+	virtual void Destroy() = 0;
+	virtual void Show() = 0;
+	virtual bool ProcessEvents() = 0;
+	virtual bool TakeResize() = 0;
+
+	virtual bool CreateSurface(VkInstance instance, VkSurfaceKHR *surface) = 0;
+};
\ No newline at end of file
@@ -1,15 +1,63 @@
+#include <cinttypes>
+#include <cerrno>
+#include <cstring>
 #include "VulkanSample.h"
+#include "VulkanHeadlessBackend.h"
+#include "VulkanWin32Backend.h"
 
 VulkanSample::VulkanSample()
 	: mLogger("VulkanSample.log"),
 	mVulkanInstance(nullptr),
 	mPhysicalDevice(nullptr),
+	mComputeQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED),
+	mTransferQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED),
+	mTransferQueueFamilyOffset(0),
+	mComputeQueueIndex(0),
+	mTransferQueueIndex(0),
+	mComputeQueuePriority(1.0f),
+	mTransferQueuePriority(1.0f),
 	mDevice(nullptr),
 	mPresentationSurface(nullptr),
 	mOldSwapChain(VK_NULL_HANDLE),
 	mSwapChain(VK_NULL_HANDLE),
-	mCommandPool(nullptr)
+	mSwapChainDirty(false),
+	mCommandPool(nullptr),
+	mStagingAllocation({ nullptr, 0, 0 }),
+	mDedicatedAllocationEnabled(false),
+	mDedicatedAllocationThreshold(VulkanMemoryAllocator::DefaultBlockSize / 2),
+	mFrameIndex(0),
+	mFrameNumber(0),
+	mSwapChainImageIndex(0),
+	mFrameStats({ 0.0, 0.0, 0.0, 0 }),
+	mFrameStatsCpuTime(0.0),
+	mFrameStatsWaitTime(0.0),
+	mFrameStatsFrames(0),
+	mUploadStagingAllocation({ nullptr, 0, 0 }),
+	mUploadBatchIndex(0),
+	mUploadTicket(0),
+	mDeferredDestroyValue(0),
+	mResourceStats({ 0, 0, 0, 0 }),
+	mMemoryStatsInterval(0),
+	mMemoryStatsFrame(0),
+	mProperties2Enabled(false),
+	mMemoryBudgetEnabled(false),
+	mTimelineSemaphoreEnabled(false),
+	mSynchronization2Enabled(false),
+	mGetPhysicalDeviceMemoryProperties2(nullptr),
+	mGetPhysicalDeviceFeatures2(nullptr),
+	mWaitSemaphores(nullptr),
+	mGetSemaphoreCounterValue(nullptr),
+	mCmdPipelineBarrier2(nullptr),
+	mQueueSubmit2(nullptr),
+	mGetBufferMemoryRequirements2(nullptr),
+	mGetImageMemoryRequirements2(nullptr),
+	mSubmitToken(0)
 {
+#ifdef _WIN32
+	mPresentationBackend.reset(new VulkanWin32Backend());
+#else
+	mPresentationBackend.reset(new VulkanHeadlessBackend());
+#endif
 }
 
 VulkanSample::~VulkanSample()
@@ -122,13 +170,15 @@ bool VulkanSample::IsInstanceExtensionSupported(const std::string &extension)
 	return false;
 }
 
-bool VulkanSample::CreateVulkanInstance(const std::vector<char*> &desiredExtensions)
+bool VulkanSample::CreateVulkanInstance(const std::vector<const char*> &desiredExtensions)
 {
 	VkResult result = VK_SUCCESS;
 
 	if (mInstanceExtensions.size() == 0)
 		PopulateInstanceExtensions();
 
+	std::vector<const char*> enabledExtensions;
+
 	for (const auto& extension : desiredExtensions)
 	{
 		if (!IsInstanceExtensionSupported(extension))
@@ -136,8 +186,17 @@ bool VulkanSample::CreateVulkanInstance(const std::vector<char*> &desiredExtensi
 			LOG_ERROR("Extension %s is not supported", extension);
 			return false;
 		}
+
+		if (std::string(extension) != VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME)
+			enabledExtensions.push_back(extension);
 	}
 
+	mProperties2Enabled = IsInstanceExtensionSupported(
+		VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+
+	if (mProperties2Enabled)
+		enabledExtensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+
 	VkApplicationInfo applInfo =
 	{
 		VK_STRUCTURE_TYPE_APPLICATION_INFO,
@@ -157,8 +216,8 @@ bool VulkanSample::CreateVulkanInstance(const std::vector<char*> &desiredExtensi
 		&applInfo,
 		0,
 		nullptr,
-		static_cast<uint32_t>(desiredExtensions.size()),
-		desiredExtensions.size() > 0 ? &desiredExtensions[0] : nullptr
+		static_cast<uint32_t>(enabledExtensions.size()),
+		enabledExtensions.size() > 0 ? &enabledExtensions[0] : nullptr
 	};
 
 	result = vkCreateInstance(&instanceInfo, nullptr, &mVulkanInstance);
@@ -169,6 +228,18 @@ bool VulkanSample::CreateVulkanInstance(const std::vector<char*> &desiredExtensi
 		return false;
 	}
 
+	if (mProperties2Enabled)
+	{
+		mGetPhysicalDeviceMemoryProperties2 = reinterpret_cast<PFN_vkGetPhysicalDeviceMemoryProperties2KHR>(
+			vkGetInstanceProcAddr(mVulkanInstance, "vkGetPhysicalDeviceMemoryProperties2KHR"));
+
+		mGetPhysicalDeviceFeatures2 = reinterpret_cast<PFN_vkGetPhysicalDeviceFeatures2KHR>(
+			vkGetInstanceProcAddr(mVulkanInstance, "vkGetPhysicalDeviceFeatures2KHR"));
+
+		mProperties2Enabled = mGetPhysicalDeviceMemoryProperties2 != nullptr &&
+			mGetPhysicalDeviceFeatures2 != nullptr;
+	}
+
 	return true;
 }
 
@@ -296,6 +367,90 @@ bool VulkanSample::SelectQueueFamily(VkQueueFlags desiredType, bool supportPrese
 	return false;
 }
 
+bool VulkanSample::SelectAsyncQueueFamilies()
+{
+	if (mQueueFamilyProperties.size() == 0)
+		PopulateQueueFamilyProperties();
+
+	mComputeQueueFamilyIndex = FindQueueFamily(VK_QUEUE_COMPUTE_BIT, VK_QUEUE_GRAPHICS_BIT);
+	mTransferQueueFamilyIndex = FindQueueFamily(VK_QUEUE_TRANSFER_BIT, 
+		VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT);
+
+	if (mTransferQueueFamilyIndex == VK_QUEUE_FAMILY_IGNORED)
+		mTransferQueueFamilyIndex = mComputeQueueFamilyIndex;
+
+	mTransferQueueFamilyOffset = 0;
+
+	if (mTransferQueueFamilyIndex != VK_QUEUE_FAMILY_IGNORED &&
+		mTransferQueueFamilyIndex == mComputeQueueFamilyIndex &&
+		mQueueFamilyProperties[mTransferQueueFamilyIndex].queueCount > 1)
+		mTransferQueueFamilyOffset = 1;
+
+	LOG_INFO("Queue families: graphics %d, compute %d, transfer %d",
+		mQueueFamilyIndex,
+		GetQueueFamilyIndex(VulkanQueueType::Compute),
+		GetQueueFamilyIndex(VulkanQueueType::Transfer));
+
+	return mComputeQueueFamilyIndex != VK_QUEUE_FAMILY_IGNORED ||
+		mTransferQueueFamilyIndex != VK_QUEUE_FAMILY_IGNORED;
+}
+
+uint32_t VulkanSample::FindQueueFamily(VkQueueFlags requiredFlags, VkQueueFlags excludedFlags)
+{
+	for (uint32_t index = 0; index < static_cast<uint32_t>(mQueueFamilyProperties.size()); index++)
+	{
+		VkQueueFlags flags = mQueueFamilyProperties[index].queueFlags;
+
+		if (index != mQueueFamilyIndex &&
+			mQueueFamilyProperties[index].queueCount > 0 &&
+			(flags & requiredFlags) == requiredFlags &&
+			(flags & excludedFlags) == 0)
+			return index;
+	}
+
+	return VK_QUEUE_FAMILY_IGNORED;
+}
+
+void VulkanSample::SetQueuePriority(VulkanQueueType type, float priority)
+{
+	if (type == VulkanQueueType::Compute)
+		mComputeQueuePriority = priority;
+	else if (type == VulkanQueueType::Transfer)
+		mTransferQueuePriority = priority;
+}
+
+bool VulkanSample::HasDedicatedQueue(VulkanQueueType type) const
+{
+	return GetQueueIndex(type) != 0;
+}
+
+uint32_t VulkanSample::GetQueueFamilyIndex(VulkanQueueType type) const
+{
+	if (type == VulkanQueueType::Compute && mComputeQueueFamilyIndex != VK_QUEUE_FAMILY_IGNORED)
+		return mComputeQueueFamilyIndex;
+
+	if (type == VulkanQueueType::Transfer && mTransferQueueFamilyIndex != VK_QUEUE_FAMILY_IGNORED)
+		return mTransferQueueFamilyIndex;
+
+	return mQueueFamilyIndex;
+}
+
+uint32_t VulkanSample::GetQueueIndex(VulkanQueueType type) const
+{
+	if (type == VulkanQueueType::Compute)
+		return mComputeQueueIndex;
+
+	if (type == VulkanQueueType::Transfer)
+		return mTransferQueueIndex;
+
+	return 0;
+}
+
+VkQueue VulkanSample::GetQueue(VulkanQueueType type) const
+{
+	return mQueues[GetQueueIndex(type)];
+}
+
 bool VulkanSample::IsDeviceExtensionSupported(const std::string &extension)
 {
 	for (const auto& supportedExtension : mDeviceExtensions)
@@ -319,6 +474,94 @@ bool VulkanSample::CreateDevice(const std::vector<char*>& desiredExtensions,
 		}
 	}
 
+	std::vector<const char*> enabledExtensions(desiredExtensions.begin(), 
+		desiredExtensions.end());
+
+	mDedicatedAllocationEnabled =
+		IsDeviceExtensionSupported(VK_KHR_GET_MEMORY_REQUIREMENTS_2_EXTENSION_NAME) &&
+		IsDeviceExtensionSupported(VK_KHR_DEDICATED_ALLOCATION_EXTENSION_NAME);
+
+	if (mDedicatedAllocationEnabled)
+	{
+		enabledExtensions.push_back(VK_KHR_GET_MEMORY_REQUIREMENTS_2_EXTENSION_NAME);
+		enabledExtensions.push_back(VK_KHR_DEDICATED_ALLOCATION_EXTENSION_NAME);
+	}
+
+	mMemoryBudgetEnabled = mProperties2Enabled &&
+		IsDeviceExtensionSupported(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+
+	if (mMemoryBudgetEnabled)
+		enabledExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+
+	VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timelineFeatures =
+	{
+		VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR,
+		nullptr,
+		VK_FALSE
+	};
+
+	VkPhysicalDeviceSynchronization2FeaturesKHR synchronization2Features =
+	{
+		VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR,
+		nullptr,
+		VK_FALSE
+	};
+
+	mTimelineSemaphoreEnabled = false;
+	mSynchronization2Enabled = false;
+
+	if (mProperties2Enabled)
+	{
+		VkPhysicalDeviceFeatures2KHR features =
+		{
+			VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR,
+			nullptr
+		};
+
+		if (IsDeviceExtensionSupported(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME))
+		{
+			timelineFeatures.pNext = features.pNext;
+			features.pNext = &timelineFeatures;
+		}
+
+		if (IsDeviceExtensionSupported(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME))
+		{
+			synchronization2Features.pNext = features.pNext;
+			features.pNext = &synchronization2Features;
+		}
+
+		mGetPhysicalDeviceFeatures2(mPhysicalDevice, &features);
+		mTimelineSemaphoreEnabled = timelineFeatures.timelineSemaphore == VK_TRUE;
+		mSynchronization2Enabled = synchronization2Features.synchronization2 == VK_TRUE;
+	}
+
+	void *deviceCreateNext = nullptr;
+
+	timelineFeatures.pNext = nullptr;
+	synchronization2Features.pNext = nullptr;
+
+	if (mTimelineSemaphoreEnabled)
+	{
+		enabledExtensions.push_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+		timelineFeatures.pNext = deviceCreateNext;
+		deviceCreateNext = &timelineFeatures;
+	}
+	else
+	{
+		LOG_INFO("Timeline semaphores unavailable, falling back to fences");
+	}
+
+	if (mSynchronization2Enabled)
+	{
+		enabledExtensions.push_back(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
+		synchronization2Features.pNext = deviceCreateNext;
+		deviceCreateNext = &synchronization2Features;
+	}
+	else
+	{
+		LOG_INFO("Synchronization2 unavailable, using legacy barriers and submits");
+	}
+
 	std::vector<VkDeviceQueueCreateInfo> queueCreateInfos =
 	{
 		VkDeviceQueueCreateInfo
@@ -332,17 +575,48 @@ bool VulkanSample::CreateDevice(const std::vector<char*>& desiredExtensions,
 		}
 	};
 
+	std::vector<float> computeQueuePriorities = { mComputeQueuePriority };
+	std::vector<float> transferQueuePriorities = { mTransferQueuePriority };
+
+	if (mTransferQueueFamilyOffset > 0)
+		computeQueuePriorities.push_back(mTransferQueuePriority);
+
+	if (mComputeQueueFamilyIndex != VK_QUEUE_FAMILY_IGNORED)
+	{
+		queueCreateInfos.push_back({
+			VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+			nullptr,
+			0,
+			mComputeQueueFamilyIndex,
+			static_cast<uint32_t>(computeQueuePriorities.size()),
+			&computeQueuePriorities[0]
+		});
+	}
+
+	if (mTransferQueueFamilyIndex != VK_QUEUE_FAMILY_IGNORED &&
+		mTransferQueueFamilyIndex != mComputeQueueFamilyIndex)
+	{
+		queueCreateInfos.push_back({
+			VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+			nullptr,
+			0,
+			mTransferQueueFamilyIndex,
+			static_cast<uint32_t>(transferQueuePriorities.size()),
+			&transferQueuePriorities[0]
+		});
+	}
+
 	VkDeviceCreateInfo deviceCreateInfo =
 	{
 		VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
-		nullptr,
+		deviceCreateNext,
 		0,
 		static_cast<uint32_t>(queueCreateInfos.size()),
 		queueCreateInfos.size() > 0 ? &queueCreateInfos[0] : nullptr,
 		0,
 		nullptr,
-		static_cast<uint32_t>(desiredExtensions.size()),
-		desiredExtensions.size() > 0 ? &desiredExtensions[0] : nullptr,
+		static_cast<uint32_t>(enabledExtensions.size()),
+		enabledExtensions.size() > 0 ? &enabledExtensions[0] : nullptr,
 		&mPhysicalDeviceFeatures
 	};
 
@@ -358,11 +632,81 @@ bool VulkanSample::CreateDevice(const std::vector<char*>& desiredExtensions,
 		return false;
 	}
 
+	if (mDedicatedAllocationEnabled)
+	{
+		mGetBufferMemoryRequirements2 = reinterpret_cast<PFN_vkGetBufferMemoryRequirements2KHR>(
+			vkGetDeviceProcAddr(mDevice, "vkGetBufferMemoryRequirements2KHR"));
+
+		mGetImageMemoryRequirements2 = reinterpret_cast<PFN_vkGetImageMemoryRequirements2KHR>(
+			vkGetDeviceProcAddr(mDevice, "vkGetImageMemoryRequirements2KHR"));
+
+		if (mGetBufferMemoryRequirements2 == nullptr || mGetImageMemoryRequirements2 == nullptr)
+		{
+			LOG_WARN("Dedicated allocation entry points are unavailable");
+			mDedicatedAllocationEnabled = false;
+		}
+	}
+
+	if (mTimelineSemaphoreEnabled)
+	{
+		mWaitSemaphores = reinterpret_cast<PFN_vkWaitSemaphoresKHR>(
+			vkGetDeviceProcAddr(mDevice, "vkWaitSemaphoresKHR"));
+
+		mGetSemaphoreCounterValue = reinterpret_cast<PFN_vkGetSemaphoreCounterValueKHR>(
+			vkGetDeviceProcAddr(mDevice, "vkGetSemaphoreCounterValueKHR"));
+
+		if (mWaitSemaphores == nullptr || mGetSemaphoreCounterValue == nullptr)
+		{
+			LOG_WARN("Timeline semaphore entry points are unavailable");
+			mTimelineSemaphoreEnabled = false;
+		}
+	}
+
+	if (mSynchronization2Enabled)
+	{
+		mCmdPipelineBarrier2 = reinterpret_cast<PFN_vkCmdPipelineBarrier2KHR>(
+			vkGetDeviceProcAddr(mDevice, "vkCmdPipelineBarrier2KHR"));
+
+		mQueueSubmit2 = reinterpret_cast<PFN_vkQueueSubmit2KHR>(
+			vkGetDeviceProcAddr(mDevice, "vkQueueSubmit2KHR"));
+
+		if (mCmdPipelineBarrier2 == nullptr || mQueueSubmit2 == nullptr)
+		{
+			LOG_WARN("Synchronization2 entry points are unavailable");
+			mSynchronization2Enabled = false;
+			mCmdPipelineBarrier2 = nullptr;
+			mQueueSubmit2 = nullptr;
+		}
+	}
+
+	if (!mAllocator.Initialize(mDevice, mPhysicalDeviceMemoryProperties,
+		mPhysicalDeviceProperties.limits.bufferImageGranularity,
+		mPhysicalDeviceProperties.limits.nonCoherentAtomSize,
+		mDedicatedAllocationEnabled))
+	{
+		LOG_ERROR("Unable to initialize memory allocator");
+		return false;
+	}
+
+	if (!mSyncPool.Initialize(mDevice) || !mFenceWatcher.Initialize(mDevice))
+		return false;
+
 	return true;
 }
 
 void VulkanSample::DestroyDevice()
 {
+	StopSubmitThread();
+	mFenceWatcher.Destroy();
+	DestroyFrameContexts();
+	DestroyUploadEngine();
+	DestroyQueueTimelines();
+	FlushDeferredDestroys();
+	mSyncPool.Destroy();
+	DestroyThreadCommandPools();
+	DestroyFrameCommandRecycler();
+	mAllocator.Destroy();
+
 	if (mDevice)
 		vkDestroyDevice(mDevice, nullptr);
 
@@ -385,50 +729,100 @@ bool VulkanSample::GetQueues(uint32_t queueCount)
 		}
 	}
 
+	mComputeQueueIndex = 0;
+	mTransferQueueIndex = 0;
+
+	if (mComputeQueueFamilyIndex != VK_QUEUE_FAMILY_IGNORED)
+	{
+		mComputeQueueIndex = static_cast<uint32_t>(mQueues.size());
+		mQueues.push_back(nullptr);
+
+		vkGetDeviceQueue(mDevice, mComputeQueueFamilyIndex, 
+			0, &mQueues[mComputeQueueIndex]);
+	}
+
+	if (mTransferQueueFamilyIndex != VK_QUEUE_FAMILY_IGNORED)
+	{
+		if (mTransferQueueFamilyIndex == mComputeQueueFamilyIndex && mTransferQueueFamilyOffset == 0)
+		{
+			mTransferQueueIndex = mComputeQueueIndex;
+		}
+		else
+		{
+			mTransferQueueIndex = static_cast<uint32_t>(mQueues.size());
+			mQueues.push_back(nullptr);
+
+			vkGetDeviceQueue(mDevice, mTransferQueueFamilyIndex, 
+				mTransferQueueFamilyOffset, &mQueues[mTransferQueueIndex]);
+		}
+	}
+
+	mSubmitBatchers.resize(mQueues.size());
+
+	for (uint32_t index = 0; index < static_cast<uint32_t>(mQueues.size()); index++)
+	{
+		if (mQueues[index] == nullptr)
+		{
+			LOG_ERROR("Unable to get queue[%d]", index);
+			return false;
+		}
+
+		mSubmitBatchers[index].Initialize(mQueues[index], mQueueSubmit2);
+	}
+
+	if (!CreateQueueTimelines())
+		return false;
+
 	return true;
 }
 
+void VulkanSample::SetPresentationBackend(std::unique_ptr<VulkanPresentationBackend> backend)
+{
+	if (mPresentationBackend)
+		mPresentationBackend->Destroy();
+
+	mPresentationBackend = std::move(backend);
+}
+
+const char* VulkanSample::GetPresentationSurfaceExtension() const
+{
+	return mPresentationBackend->GetSurfaceExtensionName();
+}
+
 bool VulkanSample::CreateVulkanWindow(uint32_t width, uint32_t height, const std::string & title)
 {
-	return mWindow.Create(width, height, title);
+	return mPresentationBackend->Create(width, height, title);
 }
 
 void VulkanSample::ShowVulkanWindow()
 {
-	mWindow.Show();
+	mPresentationBackend->Show();
 }
 
 void VulkanSample::DestroyVulkanWindow()
 {
-	mWindow.Destroy();
+	mPresentationBackend->Destroy();
 }
 
-bool VulkanSample::CreatePresentationSurface()
+bool VulkanSample::ProcessEvents()
 {
-	VkResult result = VK_SUCCESS;
-
-	VkWin32SurfaceCreateInfoKHR surfaceInfo =
-	{
-		VK_STRUCTURE_TYPE_WIN32_SURFACE_CREATE_INFO_KHR,
-		nullptr,
-		0,
-		GetModuleHandle(nullptr),
-		mWindow.GetHandle()
-	};
-
-	result = vkCreateWin32SurfaceKHR(
-		mVulkanInstance,
-		&surfaceInfo,
-		nullptr,
-		&mPresentationSurface);
+	return mPresentationBackend->ProcessEvents();
+}
 
-	if (result != VK_SUCCESS || mPresentationSurface == nullptr)
+bool VulkanSample::CreatePresentationSurface()
+{
+	if (!mPresentationBackend->CreateSurface(mVulkanInstance, &mPresentationSurface))
 	{
 		LOG_ERROR("Unable to create presentation surface");
 		return false;
 	}
 
-	result = vkGetPhysicalDeviceSurfaceCapabilitiesKHR(
+	return UpdatePresentationSurfaceCapabilities();
+}
+
+bool VulkanSample::UpdatePresentationSurfaceCapabilities()
+{
+	VkResult result = vkGetPhysicalDeviceSurfaceCapabilitiesKHR(
 		mPhysicalDevice,
 		mPresentationSurface,
 		&mPresentationSurfaceCapabilities
@@ -451,8 +845,8 @@ bool VulkanSample::CreatePresentationSurface()
 	{
 		mSwapChainImageSize =
 		{
-			mWindow.GetWidth(),
-			mWindow.GetHeight()
+			mPresentationBackend->GetWidth(),
+			mPresentationBackend->GetHeight()
 		};
 
 		if (mSwapChainImageSize.width < mPresentationSurfaceCapabilities.minImageExtent.width)
@@ -629,7 +1023,8 @@ bool VulkanSample::CreateSwapChain()
 		mPresentationSurfaceFormat.colorSpace,
 		mSwapChainImageSize,
 		1,
-		VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
+		VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | 
+			(mPresentationSurfaceCapabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_DST_BIT),
 		VK_SHARING_MODE_EXCLUSIVE,
 		0,
 		nullptr,
@@ -640,24 +1035,32 @@ bool VulkanSample::CreateSwapChain()
 		mOldSwapChain
 	};
 
+	VkSwapchainKHR swapChain = VK_NULL_HANDLE;
+
 	result = vkCreateSwapchainKHR(
 		mDevice,
 		&swapChainCreateInfo,
 		nullptr,
-		&mSwapChain
+		&swapChain
 	);
 
-	if (result != VK_SUCCESS || mSwapChain == nullptr)
+	// the old swapchain is retired whether or not creation succeeded
+	if (mOldSwapChain != VK_NULL_HANDLE)
 	{
-		LOG_ERROR("Unable to create Swapchain");
-		return false;
+		QueueDestroySwapChain(mOldSwapChain);
+		mOldSwapChain = nullptr;
 	}
 
-	if (mOldSwapChain != VK_NULL_HANDLE)
+	if (result != VK_SUCCESS || swapChain == VK_NULL_HANDLE)
 	{
-		vkDestroySwapchainKHR(mDevice, mOldSwapChain, nullptr);
-		mOldSwapChain = nullptr;
+		LOG_ERROR("Unable to create Swapchain");
+		mSwapChain = VK_NULL_HANDLE;
+		return false;
 	}
+
+	mSwapChain = swapChain;
+
+	mSwapChainDirty = false;
 	
 	uint32_t swapChainImageCount = 0;
 
@@ -689,11 +1092,86 @@ bool VulkanSample::CreateSwapChain()
 		return false;
 	}
 
+	return CreateRenderFinishedSemaphores();
+}
+
+bool VulkanSample::CreateRenderFinishedSemaphores()
+{
+	// presents of the previous swapchain may still wait on the old semaphores
+	ReleaseRenderFinishedSemaphores();
+
+	mRenderFinishedSemaphores.resize(mSwapChainImages.size(), nullptr);
+
+	for (auto& semaphore : mRenderFinishedSemaphores)
+	{
+		if (!AcquireVulkanSemaphore(&semaphore))
+		{
+			LOG_ERROR("Unable to create Swapchain semaphores");
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void VulkanSample::ReleaseRenderFinishedSemaphores()
+{
+	for (auto semaphore : mRenderFinishedSemaphores)
+	{
+		if (semaphore)
+			ReleaseVulkanSemaphore(semaphore);
+	}
+
+	mRenderFinishedSemaphores.clear();
+}
+
+bool VulkanSample::RecreateSwapChain()
+{
+	if (mSubmitThread.IsRunning())
+	{
+		// the submit thread owns the swapchain while it has packets in flight
+		WaitForSubmitToken(mSubmitToken);
+		mSubmitThread.TakePresentResult();
+	}
+
+	if (!UpdatePresentationSurfaceCapabilities())
+		return false;
+
+	while (mSwapChainImageSize.width == 0 || mSwapChainImageSize.height == 0)
+	{
+		if (!mPresentationBackend->ProcessEvents())
+			return false;
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+		if (!UpdatePresentationSurfaceCapabilities())
+			return false;
+	}
+
+	uint64_t deferredDestroyValue = mDeferredDestroyValue;
+
+	// retire the old swapchain with the first frame submitted after its last present
+	mOldSwapChain = mSwapChain;
+	SetDeferredDestroyValue(mFrameNumber + 1);
+
+	bool result = CreateSwapChain();
+	SetDeferredDestroyValue(deferredDestroyValue);
+
+	if (!result)
+	{
+		LOG_ERROR("Unable to recreate Swapchain");
+		return false;
+	}
+
+	LOG_INFO("Swapchain recreated %ux%u", mSwapChainImageSize.width, mSwapChainImageSize.height);
 	return true;
 }
 
 void VulkanSample::DestroySwapChain()
 {
+	FlushDeferredDestroys();
+	ReleaseRenderFinishedSemaphores();
+
 	if (mSwapChain)
 		vkDestroySwapchainKHR(mDevice, mSwapChain, nullptr);
 
@@ -793,25 +1271,356 @@ void VulkanSample::FreeCommandBuffers(const std::vector<VkCommandBuffer>& buffer
 	);
 }
 
-bool VulkanSample::BeginCommandBuffer(VkCommandBuffer buffer, VkCommandBufferLevel level, 
-	VkCommandBufferUsageFlags usage, VkCommandBufferInheritanceInfo *inheritenceInfo)
+bool VulkanSample::CreateFrameCommandRecycler(uint32_t frameCount)
 {
-	VkResult result = VK_SUCCESS;
+	return mFrameCommandRecycler.Initialize(mDevice, mQueueFamilyIndex, frameCount);
+}
 
-	VkCommandBufferBeginInfo beginInfo =
-	{
-		VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-		nullptr,
-		usage,
-		inheritenceInfo
-	};
+void VulkanSample::DestroyFrameCommandRecycler()
+{
+	mFrameCommandRecycler.Destroy();
+}
 
-	result = vkBeginCommandBuffer(
-		buffer,
-		&beginInfo
-	);
+bool VulkanSample::ResetFrameCommandBuffers(uint32_t frameIndex)
+{
+	return mFrameCommandRecycler.Reset(frameIndex);
+}
 
-	if (result != VK_SUCCESS)
+bool VulkanSample::AcquireFrameCommandBuffer(uint32_t frameIndex,
+	VkCommandBufferLevel level,
+	VkCommandBuffer *buffer)
+{
+	return mFrameCommandRecycler.Acquire(frameIndex, level, buffer);
+}
+
+bool VulkanSample::CreateFrameContexts(uint32_t frameCount)
+{
+	if (!CreateFrameCommandRecycler(frameCount))
+	{
+		LOG_ERROR("Unable to create Frame command recycler");
+		return false;
+	}
+
+	mFrameContexts.resize(frameCount);
+
+	for (auto& frame : mFrameContexts)
+	{
+		frame = { nullptr, nullptr, nullptr, 0, 0 };
+
+		// pooled fences come back unsignalled, the first wait on a frame fence needs it signalled
+		if (!CreateFence(&frame.Fence, true) ||
+			!AcquireVulkanSemaphore(&frame.ImageAvailable))
+		{
+			LOG_ERROR("Unable to create Frame context");
+			DestroyFrameContexts();
+			return false;
+		}
+	}
+
+	mFrameIndex = 0;
+	mFrameStats = { 0.0, 0.0, 0.0, 0 };
+	mFrameStatsStart = Clock::now();
+	mFrameStatsCpuTime = 0.0;
+	mFrameStatsWaitTime = 0.0;
+	mFrameStatsFrames = 0;
+
+	return true;
+}
+
+void VulkanSample::DestroyFrameContexts()
+{
+	WaitForSubmitToken(mSubmitToken);
+
+	// a frame whose submit failed never signals its fence
+	if (mDevice)
+		vkDeviceWaitIdle(mDevice);
+
+	for (const auto& frame : mFrameContexts)
+	{
+		ReleaseVulkanSemaphore(frame.ImageAvailable);
+		DestroyFence(frame.Fence);
+	}
+
+	mFrameContexts.clear();
+	DestroyFrameCommandRecycler();
+}
+
+bool VulkanSample::BeginFrame(VkCommandBuffer *commandBuffer)
+{
+	Clock::time_point waitStart = Clock::now();
+	FrameContext &frame = mFrameContexts[mFrameIndex];
+
+	if (mSubmitThread.IsRunning())
+	{
+		WaitForSubmitToken(frame.SubmitToken);
+
+		if (!CheckSubmitThreadResult())
+			return false;
+	}
+
+	if (WaitForFences({ frame.Fence }, true, UINT64_MAX) != VK_SUCCESS)
+		return false;
+
+	RetireDeferredDestroys(frame.FrameNumber);
+
+	// the ring still references this fence, retire it before the reset
+	mStagingRing.RetireFrames();
+
+	if (mPresentationBackend->TakeResize())
+		mSwapChainDirty = true;
+
+	if (mSwapChainDirty && !RecreateSwapChain())
+		return false;
+
+	// the acquire runs on the submit thread while the frame is set up
+	uint64_t acquireToken = BeginSwapChainAcquire(frame.ImageAvailable);
+
+	frame.FrameNumber = ++mFrameNumber;
+	SetDeferredDestroyValue(mFrameNumber);
+
+	if (!ResetFrameCommandBuffers(mFrameIndex) ||
+		!ResetThreadCommandPools(mFrameIndex) ||
+		!AcquireFrameCommandBuffer(mFrameIndex, VK_COMMAND_BUFFER_LEVEL_PRIMARY, &frame.CommandBuffer))
+		return false;
+
+	if (!BeginCommandBuffer(frame.CommandBuffer, VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+		VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, nullptr))
+		return false;
+
+	VkResult result = EndSwapChainAcquire(acquireToken, frame.ImageAvailable);
+
+	if (result == VK_ERROR_OUT_OF_DATE_KHR)
+	{
+		if (!RecreateSwapChain())
+			return false;
+
+		result = EndSwapChainAcquire(BeginSwapChainAcquire(frame.ImageAvailable), 
+			frame.ImageAvailable);
+	}
+
+	if (result == VK_SUBOPTIMAL_KHR)
+		mSwapChainDirty = true;
+
+	if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
+	{
+		LOG_ERROR("Unable to acquire Swapchain image");
+		return false;
+	}
+
+	mFrameCpuStart = Clock::now();
+	mFrameStats.WaitTime = std::chrono::duration<double, std::milli>(mFrameCpuStart - waitStart).count();
+
+	mFrameWaitSemaphores = { frame.ImageAvailable };
+	mFrameWaitStages = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT };
+
+	AcquireUploads(frame.CommandBuffer, mFrameWaitSemaphores, mFrameWaitStages);
+
+	*commandBuffer = frame.CommandBuffer;
+	return true;
+}
+
+bool VulkanSample::EndFrame()
+{
+	FrameContext &frame = mFrameContexts[mFrameIndex];
+
+	VkSemaphore renderFinished = mRenderFinishedSemaphores[mSwapChainImageIndex];
+
+	if (!EndCommandBuffer(frame.CommandBuffer) || !FlushMappedMemoryRanges())
+		return false;
+
+	// reset only once the fence is certain to be submitted
+	if (!ResetFences({ frame.Fence }))
+		return false;
+
+	QueueSubmitCommandBuffers(0, 
+		{ frame.CommandBuffer },
+		mFrameWaitSemaphores,
+		mFrameWaitStages,
+		{ renderFinished },
+		frame.Fence);
+
+	if (!FlushAllSubmits())
+		return false;
+
+	frame.SubmitToken = mSubmitToken;
+	EndUploadAcquires();
+
+	EndStagingFrame(frame.Fence);
+
+	VkResult result = PresentSwapChainImage({ renderFinished });
+
+	mFrameIndex = (mFrameIndex + 1) % static_cast<uint32_t>(mFrameContexts.size());
+
+	UpdateFrameStats(mFrameStats.WaitTime, 
+		std::chrono::duration<double, std::milli>(Clock::now() - mFrameCpuStart).count());
+
+	UpdateMemoryStats();
+
+	return CheckPresentResult(result);
+}
+
+void VulkanSample::GetFrameStats(VulkanFrameStats *stats)
+{
+	*stats = mFrameStats;
+}
+
+void VulkanSample::UpdateFrameStats(double waitTime, double cpuTime)
+{
+	mFrameStats.CpuTime = cpuTime;
+	mFrameStats.WaitTime = waitTime;
+	mFrameStats.FrameCount++;
+
+	mFrameStatsCpuTime += cpuTime;
+	mFrameStatsWaitTime += waitTime;
+	mFrameStatsFrames++;
+
+	double elapsed = std::chrono::duration<double>(Clock::now() - mFrameStatsStart).count();
+
+	if (elapsed < 1.0)
+		return;
+
+	mFrameStats.FramesPerSecond = mFrameStatsFrames / elapsed;
+
+	LOG_INFO("Frame: %.1f fps, cpu %.3f ms, wait %.3f ms", 
+		mFrameStats.FramesPerSecond,
+		mFrameStatsCpuTime / mFrameStatsFrames,
+		mFrameStatsWaitTime / mFrameStatsFrames);
+
+	mFrameStatsStart = Clock::now();
+	mFrameStatsCpuTime = 0.0;
+	mFrameStatsWaitTime = 0.0;
+	mFrameStatsFrames = 0;
+}
+
+bool VulkanSample::CreateThreadCommandPools(uint32_t threadCount, uint32_t frameCount)
+{
+	if (threadCount == 0 || frameCount == 0)
+	{
+		LOG_ERROR("Invalid thread Command pool count");
+		return false;
+	}
+
+	DestroyThreadCommandPools();
+
+	for (uint32_t threadIndex = 0; threadIndex < threadCount; threadIndex++)
+	{
+		mThreadCommandRecyclers.emplace_back(new VulkanCommandRecycler());
+
+		if (!mThreadCommandRecyclers.back()->Initialize(mDevice, mQueueFamilyIndex, frameCount))
+		{
+			LOG_ERROR("Unable to create thread Command pools");
+			DestroyThreadCommandPools();
+			return false;
+		}
+	}
+
+	if (!mWorkerPool.Initialize(threadCount))
+	{
+		DestroyThreadCommandPools();
+		return false;
+	}
+
+	return true;
+}
+
+void VulkanSample::DestroyThreadCommandPools()
+{
+	mWorkerPool.Destroy();
+	mThreadCommandRecyclers.clear();
+}
+
+bool VulkanSample::ResetThreadCommandPools(uint32_t frameIndex)
+{
+	for (auto& recycler : mThreadCommandRecyclers)
+	{
+		if (!recycler->Reset(frameIndex))
+			return false;
+	}
+
+	return true;
+}
+
+VkCommandPool VulkanSample::GetThreadCommandPool(uint32_t threadIndex, uint32_t frameIndex)
+{
+	return mThreadCommandRecyclers[threadIndex]->GetPool(frameIndex);
+}
+
+bool VulkanSample::AcquireThreadCommandBuffer(uint32_t threadIndex,
+	uint32_t frameIndex,
+	VkCommandBuffer *buffer)
+{
+	return mThreadCommandRecyclers[threadIndex]->Acquire(frameIndex, 
+		VK_COMMAND_BUFFER_LEVEL_SECONDARY, buffer);
+}
+
+bool VulkanSample::RecordSecondaryCommandBuffers(uint32_t frameIndex,
+	VkCommandBufferInheritanceInfo *inheritanceInfo,
+	const std::vector<std::function<void(VkCommandBuffer)>> &recorders,
+	std::vector<VkCommandBuffer> &buffers)
+{
+	std::atomic<bool> failed(false);
+
+	VkCommandBufferUsageFlags usage = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+	if (inheritanceInfo && inheritanceInfo->renderPass)
+		usage |= VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+
+	buffers.assign(recorders.size(), nullptr);
+
+	mWorkerPool.Dispatch(static_cast<uint32_t>(recorders.size()), 
+		[&](uint32_t threadIndex, uint32_t taskIndex) {
+			VkCommandBuffer buffer = nullptr;
+
+			if (!AcquireThreadCommandBuffer(threadIndex, frameIndex, &buffer) ||
+				!BeginCommandBuffer(buffer, VK_COMMAND_BUFFER_LEVEL_SECONDARY, usage, inheritanceInfo))
+			{
+				failed = true;
+				return;
+			}
+
+			recorders[taskIndex](buffer);
+
+			if (!EndCommandBuffer(buffer))
+				failed = true;
+
+			buffers[taskIndex] = buffer;
+		});
+
+	return !failed;
+}
+
+void VulkanSample::ExecuteCommandBuffers(VkCommandBuffer primaryBuffer,
+	const std::vector<VkCommandBuffer> &secondaryBuffers)
+{
+	if (secondaryBuffers.size() == 0)
+		return;
+
+	vkCmdExecuteCommands(
+		primaryBuffer,
+		static_cast<uint32_t>(secondaryBuffers.size()),
+		&secondaryBuffers[0]
+	);
+}
+
+bool VulkanSample::BeginCommandBuffer(VkCommandBuffer buffer, VkCommandBufferLevel level, 
+	VkCommandBufferUsageFlags usage, VkCommandBufferInheritanceInfo *inheritenceInfo)
+{
+	VkResult result = VK_SUCCESS;
+
+	VkCommandBufferBeginInfo beginInfo =
+	{
+		VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+		nullptr,
+		usage,
+		inheritenceInfo
+	};
+
+	result = vkBeginCommandBuffer(
+		buffer,
+		&beginInfo
+	);
+
+	if (result != VK_SUCCESS)
 	{
 		LOG_ERROR("Unable to begin Command buffer");
 		return false;
@@ -921,6 +1730,32 @@ void VulkanSample::DestroyFence(VkFence fence)
 	);
 }
 
+bool VulkanSample::AcquireVulkanSemaphore(VkSemaphore *semaphore)
+{
+	return mSyncPool.AcquireSemaphore(semaphore);
+}
+
+void VulkanSample::ReleaseVulkanSemaphore(VkSemaphore semaphore)
+{
+	mSyncPool.ReleaseSemaphore(semaphore, mDeferredDestroyValue);
+}
+
+bool VulkanSample::AcquireFence(VkFence *fence)
+{
+	return mSyncPool.AcquireFence(fence);
+}
+
+void VulkanSample::ReleaseFence(VkFence fence)
+{
+	mFenceWatcher.Complete(fence);
+	mSyncPool.ReleaseFence(fence);
+}
+
+void VulkanSample::GetSyncPoolStats(VulkanSyncPoolStats *stats) const
+{
+	mSyncPool.GetStats(stats);
+}
+
 bool VulkanSample::ResetFences(const std::vector<VkFence>& fences)
 {
 	if (fences.size() > 0)
@@ -943,7 +1778,7 @@ bool VulkanSample::ResetFences(const std::vector<VkFence>& fences)
 	return false;
 }
 
-bool VulkanSample::WaitForFences(const std::vector<VkFence>& fences, bool waitForAll, uint64_t timeout)
+VkResult VulkanSample::WaitForFences(const std::vector<VkFence>& fences, bool waitForAll, uint64_t timeout)
 {
 	if (fences.size() > 0)
 	{
@@ -955,16 +1790,24 @@ bool VulkanSample::WaitForFences(const std::vector<VkFence>& fences, bool waitFo
 			timeout
 		);
 
-		if (result != VK_SUCCESS)
-		{
+		if (result == VK_TIMEOUT)
+			LOG_WARN("Waiting for fences timed out");
+		else if (result == VK_ERROR_DEVICE_LOST)
+			LOG_ERROR("Device lost while waiting for fences");
+		else if (result != VK_SUCCESS)
 			LOG_ERROR("Waiting for fences failed");
-			return false;
-		}
 
-		return true;
+		return result;
 	}
 
-	return false;
+	return VK_SUCCESS;
+}
+
+std::future<VkResult> VulkanSample::WatchFence(VkFence fence, 
+	const VulkanFenceWatcher::Callback &callback,
+	uint64_t timeout)
+{
+	return mFenceWatcher.Add(fence, callback, timeout);
 }
 
 bool VulkanSample::SubmitCommandBuffers(uint32_t queueIndex,
@@ -974,29 +1817,16 @@ bool VulkanSample::SubmitCommandBuffers(uint32_t queueIndex,
 	const std::vector<VkSemaphore>& signaledSemaphores, 
 	VkFence fence)
 {
-	VkResult result = VK_SUCCESS;
-
-	VkSubmitInfo submitInfo =
-	{
-		VK_STRUCTURE_TYPE_SUBMIT_INFO,
-		nullptr,
-		static_cast<uint32_t>(waitSemaphores.size()),
-		waitSemaphores.size() > 0 ? &waitSemaphores[0] : nullptr,
-		waitStates.size() > 0 ? &waitStates[0] : nullptr,
-		static_cast<uint32_t>(buffers.size()),
-		buffers.size() > 0 ? &buffers[0] : nullptr,
-		static_cast<uint32_t>(signaledSemaphores.size()),
-		signaledSemaphores.size() > 0 ? &signaledSemaphores[0] : nullptr
-	};
-
-	result = vkQueueSubmit(
-		mQueues[queueIndex],
-		1,
-		&submitInfo,
+	AddSubmit(
+		queueIndex,
+		buffers,
+		waitSemaphores,
+		waitStates,
+		signaledSemaphores,
 		fence
 	);
 
-	if (result != VK_SUCCESS)
+	if (!FlushSubmits(queueIndex))
 	{
 		LOG_ERROR("Unable to submit Command buffers");
 		return false;
@@ -1005,334 +1835,1106 @@ bool VulkanSample::SubmitCommandBuffers(uint32_t queueIndex,
 	return true;
 }
 
-bool VulkanSample::CreateBuffer( 
-	VkBufferUsageFlags usage, 
-	VkDeviceSize size, 
-	VkMemoryPropertyFlags propertyFlags, 
-	VkBuffer * buffer,
-	VkDeviceMemory * memory)
+void VulkanSample::QueueSubmitCommandBuffers(uint32_t queueIndex,
+	const std::vector<VkCommandBuffer>& buffers,
+	const std::vector<VkSemaphore>& waitSemaphores,
+	const std::vector<VkPipelineStageFlags>& waitStates,
+	const std::vector<VkSemaphore>& signaledSemaphores,
+	VkFence fence)
 {
-	VkResult result = VK_SUCCESS;
-
-	VkBufferCreateInfo createInfo =
-	{
-		VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-		nullptr,
-		0,
-		size,
-		usage,
-		VK_SHARING_MODE_EXCLUSIVE,
-		0,
-		nullptr
-	};
-
-	result = vkCreateBuffer(
-		mDevice,
-		&createInfo,
-		nullptr,
-		buffer
+	AddSubmit(
+		queueIndex,
+		buffers,
+		waitSemaphores,
+		waitStates,
+		signaledSemaphores,
+		fence
 	);
+}
 
-	if (result != VK_SUCCESS || *buffer == nullptr)
+bool VulkanSample::FlushSubmits(uint32_t queueIndex)
+{
+	if (mSubmitThread.IsRunning())
 	{
-		LOG_ERROR("Unable to create buffer");
-		return false;
+		mSubmitToken = mSubmitThread.Flush(queueIndex);
+		return CheckSubmitThreadResult();
 	}
 
-	VkMemoryRequirements memoryRequirements;
-	vkGetBufferMemoryRequirements(
-		mDevice,
-		*buffer,
-		&memoryRequirements
-	);
-		
-	for (uint32_t type = 0; type < mPhysicalDeviceMemoryProperties.memoryTypeCount; type++)
-	{
-		if (memoryRequirements.memoryTypeBits & (1 << type))
-		{
-			if (mPhysicalDeviceMemoryProperties.memoryTypes[type].propertyFlags & propertyFlags)
-			{
-				VkMemoryAllocateInfo allocateInfo =
-				{
-					VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-					nullptr,
-					memoryRequirements.size,
-					type
-				};
-
-				result = vkAllocateMemory(
-					mDevice,
-					&allocateInfo,
-					nullptr,
-					memory
-				);
-
-				if (result == VK_SUCCESS)
-					break;
-			}
-		}
-	}
+	return mSubmitBatchers[queueIndex].Flush() == VK_SUCCESS;
+}
+
+bool VulkanSample::FlushAllSubmits()
+{
+	bool result = true;
 
-	if (*memory == nullptr)
+	for (uint32_t queueIndex = 0; queueIndex < static_cast<uint32_t>(mSubmitBatchers.size()); queueIndex++)
 	{
-		LOG_ERROR("Unable to allocate memory for buffer");
-		return false;
+		if (!FlushSubmits(queueIndex))
+			result = false;
 	}
 
-	result = vkBindBufferMemory(
-		mDevice,
-		*buffer,
-		*memory,
-		0
-	);
+	return result;
+}
 
-	if (result != VK_SUCCESS)
+bool VulkanSample::StartSubmitThread(uint32_t capacity)
+{
+	if (mSubmitThread.IsRunning())
+		return true;
+
+	if (!FlushAllSubmits())
+		return false;
+
+	if (!mSubmitThread.Initialize(mDevice, mQueues, mQueueSubmit2, capacity))
 	{
-		LOG_ERROR("Unable to bind memory to buffer");
+		LOG_ERROR("Unable to start submit thread");
 		return false;
 	}
 
+	mSubmitToken = 0;
+
 	return true;
 }
 
-void VulkanSample::DestroyBuffer(VkBuffer buffer, VkDeviceMemory memory)
+void VulkanSample::StopSubmitThread()
+{
+	mSubmitThread.Destroy();
+
+	mSubmitToken = 0;
+}
+
+bool VulkanSample::IsSubmitThreadRunning() const
 {
-	if (memory)
+	return mSubmitThread.IsRunning();
+}
+
+uint64_t VulkanSample::GetSubmitToken() const
+{
+	return mSubmitToken;
+}
+
+bool VulkanSample::IsSubmitTokenComplete(uint64_t token) const
+{
+	return !mSubmitThread.IsRunning() || mSubmitThread.IsComplete(token);
+}
+
+void VulkanSample::WaitForSubmitToken(uint64_t token)
+{
+	if (mSubmitThread.IsRunning())
+		mSubmitThread.Wait(token);
+}
+
+bool VulkanSample::CheckSubmitThreadResult()
+{
+	VkResult result = mSubmitThread.GetSubmitResult();
+
+	if (result != VK_SUCCESS)
 	{
-		vkFreeMemory(
-			mDevice,
-			memory,
-			nullptr
-		);
-	}		
+		LOG_ERROR("Submit thread failed to submit Command buffers (%d)", result);
+		return false;
+	}
 
-	if (buffer)
+	return true;
+}
+
+void VulkanSample::GetSubmitThreadStats(VulkanSubmitThreadStats *stats) const
+{
+	if (mSubmitThread.IsRunning())
+		mSubmitThread.GetStats(stats);
+	else
+		*stats = {};
+}
+
+void VulkanSample::AddSubmit(uint32_t queueIndex,
+	const std::vector<VkCommandBuffer> &buffers,
+	const std::vector<VkSemaphore> &waitSemaphores,
+	const std::vector<VkPipelineStageFlags> &waitStages,
+	const std::vector<VkSemaphore> &signalSemaphores,
+	VkFence fence,
+	const std::vector<uint64_t> &waitValues,
+	const std::vector<uint64_t> &signalValues)
+{
+	if (mSubmitThread.IsRunning())
 	{
-		vkDestroyBuffer(
-			mDevice,
-			buffer,
-			nullptr
-		);
+		mSubmitToken = mSubmitThread.Submit(queueIndex, buffers, waitSemaphores, 
+			waitStages, signalSemaphores, fence, waitValues, signalValues);
+	}
+	else
+	{
+		mSubmitBatchers[queueIndex].Add(buffers, waitSemaphores, 
+			waitStages, signalSemaphores, fence, waitValues, signalValues);
 	}
 }
 
-void VulkanSample::SetBuffersMemoryBarrier(VkCommandBuffer commandBuffer, 
-	const std::vector<BufferMemoryTransition> &bufferTransitions,
-	VkPipelineStageFlags generatingStages, 
-	VkPipelineStageFlags consumingStages)
+uint64_t VulkanSample::BeginSwapChainAcquire(VkSemaphore semaphore)
 {
-	std::vector<VkBufferMemoryBarrier> memoryBarriers;
+	if (!mSubmitThread.IsRunning())
+		return 0;
 
-	for (uint32_t index = 0; index < static_cast<uint32_t>(bufferTransitions.size()); index++)
+	mSubmitToken = mSubmitThread.Acquire(mSwapChain, semaphore);
+	return mSubmitToken;
+}
+
+VkResult VulkanSample::EndSwapChainAcquire(uint64_t token, VkSemaphore semaphore)
+{
+	if (mSubmitThread.IsRunning())
 	{
-		memoryBarriers.push_back({
-			VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
-			nullptr,
-			bufferTransitions[index].CurrentAccess,
-			bufferTransitions[index].NewAccess,
-			VK_QUEUE_FAMILY_IGNORED,
-			VK_QUEUE_FAMILY_IGNORED,
-			bufferTransitions[index].Buffer,
-			0,
-			VK_WHOLE_SIZE
-		});
+		WaitForSubmitToken(token);
+
+		VkResult presentResult = mSubmitThread.TakePresentResult();
+
+		if (!CheckPresentResult(presentResult))
+			return presentResult;
+
+		return mSubmitThread.GetAcquireResult(&mSwapChainImageIndex);
 	}
 
-	vkCmdPipelineBarrier(
-		commandBuffer,
-		generatingStages,
-		consumingStages,
-		0,
-		0,
-		nullptr,
-		static_cast<uint32_t>(memoryBarriers.size()),
-		memoryBarriers.size() > 0 ? &memoryBarriers[0] : nullptr,
-		0, nullptr
+	return vkAcquireNextImageKHR(
+		mDevice,
+		mSwapChain,
+		UINT64_MAX,
+		semaphore,
+		VK_NULL_HANDLE,
+		&mSwapChainImageIndex
 	);
 }
 
-bool VulkanSample::CreateBufferView(VkBuffer buffer, 
-	VkFormat format, 
-	VkDeviceSize offset, 
-	VkDeviceSize size,
-	VkBufferView * view)
+bool VulkanSample::CheckPresentResult(VkResult result)
 {
-	VkResult result = VK_SUCCESS;
+	if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR)
+	{
+		mSwapChainDirty = true;
+		return true;
+	}
 
-	VkBufferViewCreateInfo createInfo =
+	if (result != VK_SUCCESS)
 	{
-		VK_STRUCTURE_TYPE_BUFFER_VIEW_CREATE_INFO,
+		LOG_ERROR("Unable to present Swapchain image");
+		return false;
+	}
+
+	return true;
+}
+
+VkResult VulkanSample::PresentSwapChainImage(const std::vector<VkSemaphore> &waitSemaphores)
+{
+	if (mSubmitThread.IsRunning())
+	{
+		mSubmitToken = mSubmitThread.Present(0, mSwapChain, 
+			mSwapChainImageIndex, waitSemaphores);
+
+		return VK_SUCCESS;
+	}
+
+	VkPresentInfoKHR presentInfo =
+	{
+		VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
 		nullptr,
-		0,
-		buffer,
-		format,
-		offset,
-		size
+		static_cast<uint32_t>(waitSemaphores.size()),
+		waitSemaphores.size() > 0 ? &waitSemaphores[0] : nullptr,
+		1,
+		&mSwapChain,
+		&mSwapChainImageIndex,
+		nullptr
 	};
 
-	result = vkCreateBufferView(
-		mDevice,
-		&createInfo,
-		nullptr,
-		view
+	return vkQueuePresentKHR(
+		mQueues[0],
+		&presentInfo
 	);
+}
 
-	if (result != VK_SUCCESS || *view == nullptr)
+bool VulkanSample::CreateQueueTimelines()
+{
+	DestroyQueueTimelines();
+	mQueueTimelines.resize(mQueues.size());
+
+	for (auto& timeline : mQueueTimelines)
 	{
-		LOG_ERROR("Unable to create Buffer view");
-		return false;
+		timeline.Semaphore = nullptr;
+		timeline.SubmittedValue = 0;
+		timeline.CompletedValue = 0;
+
+		if (mTimelineSemaphoreEnabled && !CreateTimelineSemaphore(&timeline.Semaphore))
+		{
+			LOG_ERROR("Unable to create queue timeline");
+			return false;
+		}
 	}
 
 	return true;
 }
 
-void VulkanSample::DestroyBufferView(VkBufferView view)
+void VulkanSample::DestroyQueueTimelines()
 {
-	if (view)
-		vkDestroyBufferView(mDevice, view, nullptr);
+	for (uint32_t queueIndex = 0; queueIndex < static_cast<uint32_t>(mQueueTimelines.size()); queueIndex++)
+	{
+		QueueTimeline &timeline = mQueueTimelines[queueIndex];
+
+		WaitForTimeline(queueIndex, timeline.SubmittedValue, UINT64_MAX);
+
+		for (const auto& fence : timeline.Fences)
+			ReleaseFence(fence.second);
+
+		for (const auto& semaphore : timeline.WaitSemaphores)
+			ReleaseVulkanSemaphore(semaphore.second);
+
+		if (timeline.Semaphore)
+			DestroyVulkanSemaphore(timeline.Semaphore);
+	}
+
+	mQueueTimelines.clear();
 }
 
-bool VulkanSample::CreateImage(VkImageType type, 
-	bool cubemap, 
-	VkFormat format, 
-	VkExtent3D size, 
-	uint32_t numMipMaps, 
-	uint32_t numLayers, 
-	VkSampleCountFlagBits samples, 
-	VkImageUsageFlags usage,
-	VkMemoryPropertyFlags propertyFlags,
-	VkDeviceMemory *memory, 
-	VkImage * image)
+bool VulkanSample::CreateTimelineSemaphore(VkSemaphore *semaphore)
 {
-	VkResult result = VK_SUCCESS;
-
-	VkImageCreateInfo createInfo =
+	VkSemaphoreTypeCreateInfoKHR typeCreateInfo =
 	{
-		VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
-		nullptr,
-		cubemap ? VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT : 0ul,
-		type,
-		format,
-		size,
-		numMipMaps,
-		cubemap ? numLayers * 6 : numLayers,
-		samples,
-		VK_IMAGE_TILING_OPTIMAL,
-		usage,
-		VK_SHARING_MODE_EXCLUSIVE,
-		0,
+		VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR,
 		nullptr,
-		VK_IMAGE_LAYOUT_UNDEFINED
+		VK_SEMAPHORE_TYPE_TIMELINE_KHR,
+		0
 	};
 
-	result = vkCreateImage(
+	VkSemaphoreCreateInfo createInfo =
+	{
+		VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+		&typeCreateInfo,
+		0
+	};
+
+	VkResult result = vkCreateSemaphore(
 		mDevice,
 		&createInfo,
 		nullptr,
-		image
+		semaphore
 	);
 
-	if (result != VK_SUCCESS || *image == nullptr)
+	if (result != VK_SUCCESS)
 	{
-		LOG_ERROR("Unable to create image");
+		LOG_ERROR("Unable to create Timeline semaphore");
 		return false;
 	}
 
-	VkMemoryRequirements memoryRequirements;
-	vkGetImageMemoryRequirements(
-		mDevice,
-		*image,
-		&memoryRequirements
-	);
+	return true;
+}
+
+uint64_t VulkanSample::QueueTimelineSubmit(uint32_t queueIndex,
+	const std::vector<VkCommandBuffer> &buffers,
+	const std::vector<VulkanTimelineWait> &waits)
+{
+	QueueTimeline &timeline = mQueueTimelines[queueIndex];
+	uint64_t value = timeline.SubmittedValue + 1;
+
+	if (mTimelineSemaphoreEnabled)
+	{
+		std::vector<VkSemaphore> waitSemaphores;
+		std::vector<VkPipelineStageFlags> waitStages;
+		std::vector<uint64_t> waitValues;
+
+		for (const auto& wait : waits)
+		{
+			if (wait.QueueIndex != queueIndex)
+				FlushSubmits(wait.QueueIndex);
+
+			waitSemaphores.push_back(mQueueTimelines[wait.QueueIndex].Semaphore);
+			waitStages.push_back(wait.Stages);
+			waitValues.push_back(wait.Value);
+		}
 
-	for (uint32_t type = 0; type < mPhysicalDeviceMemoryProperties.memoryTypeCount; type++)
+		AddSubmit(queueIndex, buffers, waitSemaphores, waitStages, 
+			{ timeline.Semaphore }, nullptr, waitValues, { value });
+	}
+	else
 	{
-		if (memoryRequirements.memoryTypeBits & (1 << type))
+		VkFence fence = nullptr;
+		std::vector<VkSemaphore> waitSemaphores;
+		std::vector<VkPipelineStageFlags> waitStages;
+
+		for (const auto& wait : waits)
 		{
-			if (mPhysicalDeviceMemoryProperties.memoryTypes[type].propertyFlags & propertyFlags)
+			if (wait.Value > mQueueTimelines[wait.QueueIndex].SubmittedValue)
 			{
-				VkMemoryAllocateInfo allocateInfo =
-				{
-					VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-					nullptr,
-					memoryRequirements.size,
-					type
-				};
-
-				result = vkAllocateMemory(
-					mDevice,
-					&allocateInfo,
-					nullptr,
-					memory
-				);
-
-				if (result == VK_SUCCESS)
-					break;
+				LOG_ERROR("Timeline value %" PRIu64 " has not been submitted", wait.Value);
+				return 0;
 			}
+
+			if (GetCompletedTimelineValue(wait.QueueIndex) >= wait.Value)
+				continue;
+
+			VkSemaphore semaphore = nullptr;
+
+			if (!AcquireVulkanSemaphore(&semaphore))
+				return 0;
+
+			// an empty signal is ordered after every earlier submit on the waited queue
+			AddSubmit(wait.QueueIndex, {}, {}, {}, { semaphore }, nullptr);
+
+			if (!FlushSubmits(wait.QueueIndex))
+				return 0;
+
+			waitSemaphores.push_back(semaphore);
+			waitStages.push_back(wait.Stages);
+			timeline.WaitSemaphores.push_back({ value, semaphore });
 		}
+
+		if (!AcquireFence(&fence))
+			return 0;
+
+		AddSubmit(queueIndex, buffers, waitSemaphores, waitStages, {}, fence);
+		timeline.Fences.push_back({ value, fence });
 	}
 
-	if (*memory == nullptr)
+	timeline.SubmittedValue = value;
+	return value;
+}
+
+uint64_t VulkanSample::GetCompletedTimelineValue(uint32_t queueIndex)
+{
+	QueueTimeline &timeline = mQueueTimelines[queueIndex];
+
+	if (mTimelineSemaphoreEnabled)
 	{
-		LOG_ERROR("Unable to allocate memory for image");
-		return false;
+		uint64_t value = 0;
+
+		if (mGetSemaphoreCounterValue(mDevice, timeline.Semaphore, &value) == VK_SUCCESS)
+			timeline.CompletedValue = value;
+
+		return timeline.CompletedValue;
 	}
 
-	result = vkBindImageMemory(
-		mDevice,
-		*image,
-		*memory,
-		0
-	);
+	while (!timeline.Fences.empty() && 
+		vkGetFenceStatus(mDevice, timeline.Fences.front().second) == VK_SUCCESS)
+	{
+		timeline.CompletedValue = timeline.Fences.front().first;
+		ReleaseFence(timeline.Fences.front().second);
+		timeline.Fences.pop_front();
+	}
 
-	if (result != VK_SUCCESS)
+	while (!timeline.WaitSemaphores.empty() && 
+		timeline.WaitSemaphores.front().first <= timeline.CompletedValue)
 	{
-		LOG_ERROR("Unable to bind memory to image");
-		return false;
+		ReleaseVulkanSemaphore(timeline.WaitSemaphores.front().second);
+		timeline.WaitSemaphores.pop_front();
 	}
 
-	return true;
+	return timeline.CompletedValue;
 }
 
-void VulkanSample::DestroyImage(VkImage image, VkDeviceMemory memory)
+bool VulkanSample::WaitForTimeline(uint32_t queueIndex, uint64_t value, uint64_t timeout)
 {
-	if (memory)
-	{
-		vkFreeMemory(
-			mDevice,
-			memory,
-			nullptr
-		);
-	}
+	QueueTimeline &timeline = mQueueTimelines[queueIndex];
 
-	if (image)
+	if (value > timeline.SubmittedValue)
 	{
-		vkDestroyImage(
-			mDevice, 
-			image, 
-			nullptr
-		);
+		LOG_ERROR("Timeline value %" PRIu64 " has not been submitted", value);
+		return false;
 	}
-}
 
-void VulkanSample::SetImagesMemoryBarrier(VkCommandBuffer commandBuffer, 
-	const std::vector<ImageMemoryTransition> &imageTransitions,
-	VkPipelineStageFlags generatingStages, 
-	VkPipelineStageFlags consumingStages)
-{
-	std::vector<VkImageMemoryBarrier> memoryBarriers;
+	if (GetCompletedTimelineValue(queueIndex) >= value)
+		return true;
 
-	for (uint32_t index = 0; index < static_cast<uint32_t>(imageTransitions.size()); index++)
+	if (!FlushSubmits(queueIndex))
+		return false;
+
+	if (mTimelineSemaphoreEnabled)
 	{
-		memoryBarriers.push_back({
-			VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+		VkSemaphoreWaitInfoKHR waitInfo =
+		{
+			VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR,
 			nullptr,
-			imageTransitions[index].CurrentAccess,
+			0,
+			1,
+			&timeline.Semaphore,
+			&value
+		};
+
+		VkResult result = mWaitSemaphores(mDevice, &waitInfo, timeout);
+
+		if (result != VK_SUCCESS)
+		{
+			LOG_ERROR("Waiting for timeline value %" PRIu64 " failed", value);
+			return false;
+		}
+
+		timeline.CompletedValue = value > timeline.CompletedValue ? value : timeline.CompletedValue;
+		return true;
+	}
+
+	for (const auto& fence : timeline.Fences)
+	{
+		if (fence.first >= value)
+		{
+			if (WaitForFences({ fence.second }, true, timeout) != VK_SUCCESS)
+				return false;
+
+			break;
+		}
+	}
+
+	return GetCompletedTimelineValue(queueIndex) >= value;
+}
+
+bool VulkanSample::CreateBuffer( 
+	VkBufferUsageFlags usage, 
+	VkDeviceSize size, 
+	VulkanMemoryUsage memoryUsage, 
+	VkBuffer * buffer,
+	VulkanAllocation * allocation)
+{
+	VkResult result = VK_SUCCESS;
+
+	VkBufferCreateInfo createInfo =
+	{
+		VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+		nullptr,
+		0,
+		size,
+		usage,
+		VK_SHARING_MODE_EXCLUSIVE,
+		0,
+		nullptr
+	};
+
+	result = vkCreateBuffer(
+		mDevice,
+		&createInfo,
+		nullptr,
+		buffer
+	);
+
+	if (result != VK_SUCCESS || *buffer == nullptr)
+	{
+		LOG_ERROR("Unable to create buffer");
+		return false;
+	}
+
+	mResourceStats.BufferCount++;
+
+	VkMemoryRequirements memoryRequirements;
+	bool dedicated = false;
+
+	GetBufferMemoryRequirements(
+		*buffer,
+		&memoryRequirements,
+		&dedicated
+	);
+
+	bool allocated = dedicated ?
+		mAllocator.AllocateDedicated(memoryRequirements, memoryUsage, *buffer, nullptr, allocation) :
+		mAllocator.Allocate(memoryRequirements, memoryUsage, VulkanSuballocationType::Linear, allocation);
+
+	if (!allocated)
+	{
+		LOG_ERROR("Unable to allocate memory for buffer");
+		DestroyBuffer(*buffer, { nullptr, 0, 0 });
+		*buffer = nullptr;
+		return false;
+	}
+
+	result = vkBindBufferMemory(
+		mDevice,
+		*buffer,
+		allocation->Block->GetMemory(),
+		allocation->Offset
+	);
+
+	if (result != VK_SUCCESS)
+	{
+		LOG_ERROR("Unable to bind memory to buffer");
+		DestroyBuffer(*buffer, *allocation);
+		*buffer = nullptr;
+		*allocation = { nullptr, 0, 0 };
+		return false;
+	}
+
+	return true;
+}
+
+void VulkanSample::DestroyBuffer(VkBuffer buffer, const VulkanAllocation &allocation)
+{
+	if (allocation.Block)
+		mAllocator.Free(allocation);
+
+	if (buffer)
+	{
+		vkDestroyBuffer(
+			mDevice,
+			buffer,
+			nullptr
+		);
+
+		mResourceStats.BufferCount--;
+	}
+}
+
+void VulkanSample::SetBuffersMemoryBarrier(VkCommandBuffer commandBuffer, 
+	const std::vector<BufferMemoryTransition> &bufferTransitions,
+	VkPipelineStageFlags generatingStages, 
+	VkPipelineStageFlags consumingStages)
+{
+	std::vector<VkBufferMemoryBarrier> memoryBarriers;
+
+	for (uint32_t index = 0; index < static_cast<uint32_t>(bufferTransitions.size()); index++)
+	{
+		memoryBarriers.push_back({
+			VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+			nullptr,
+			bufferTransitions[index].CurrentAccess,
+			bufferTransitions[index].NewAccess,
+			bufferTransitions[index].SrcQueueFamily,
+			bufferTransitions[index].DstQueueFamily,
+			bufferTransitions[index].Buffer,
+			0,
+			VK_WHOLE_SIZE
+		});
+	}
+
+	vkCmdPipelineBarrier(
+		commandBuffer,
+		generatingStages,
+		consumingStages,
+		0,
+		0,
+		nullptr,
+		static_cast<uint32_t>(memoryBarriers.size()),
+		memoryBarriers.size() > 0 ? &memoryBarriers[0] : nullptr,
+		0, nullptr
+	);
+}
+
+static VkPipelineStageFlags ToLegacyStages(VkPipelineStageFlags2KHR stages)
+{
+	VkPipelineStageFlags legacyStages = static_cast<VkPipelineStageFlags>(stages & 0xFFFFFFFFull);
+
+	if (stages & (VK_PIPELINE_STAGE_2_COPY_BIT_KHR | VK_PIPELINE_STAGE_2_RESOLVE_BIT_KHR |
+		VK_PIPELINE_STAGE_2_BLIT_BIT_KHR | VK_PIPELINE_STAGE_2_CLEAR_BIT_KHR))
+		legacyStages |= VK_PIPELINE_STAGE_TRANSFER_BIT;
+	if (stages & (VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT_KHR | VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT_KHR))
+		legacyStages |= VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+	if (stages & VK_PIPELINE_STAGE_2_PRE_RASTERIZATION_SHADERS_BIT_KHR)
+		legacyStages |= VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_TESSELLATION_CONTROL_SHADER_BIT |
+			VK_PIPELINE_STAGE_TESSELLATION_EVALUATION_SHADER_BIT | VK_PIPELINE_STAGE_GEOMETRY_SHADER_BIT;
+
+	return legacyStages;
+}
+
+static VkAccessFlags ToLegacyAccess(VkAccessFlags2KHR access)
+{
+	VkAccessFlags legacyAccess = static_cast<VkAccessFlags>(access & 0xFFFFFFFFull);
+
+	if (access & (VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR | VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR))
+		legacyAccess |= VK_ACCESS_SHADER_READ_BIT;
+	if (access & VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR)
+		legacyAccess |= VK_ACCESS_SHADER_WRITE_BIT;
+
+	return legacyAccess;
+}
+
+void VulkanSample::SetMemoryDependencies(VkCommandBuffer commandBuffer,
+	const std::vector<BufferMemoryDependency> &bufferDependencies,
+	const std::vector<ImageMemoryDependency> &imageDependencies)
+{
+	if (bufferDependencies.empty() && imageDependencies.empty())
+		return;
+
+	if (mSynchronization2Enabled)
+	{
+		std::vector<VkBufferMemoryBarrier2KHR> bufferBarriers;
+		std::vector<VkImageMemoryBarrier2KHR> imageBarriers;
+
+		for (const auto& dependency : bufferDependencies)
+		{
+			bufferBarriers.push_back({
+				VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2_KHR,
+				nullptr,
+				dependency.SrcStages,
+				dependency.SrcAccess,
+				dependency.DstStages,
+				dependency.DstAccess,
+				dependency.SrcQueueFamily,
+				dependency.DstQueueFamily,
+				dependency.Buffer,
+				dependency.Offset,
+				dependency.Size
+			});
+		}
+
+		for (const auto& dependency : imageDependencies)
+		{
+			imageBarriers.push_back({
+				VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR,
+				nullptr,
+				dependency.SrcStages,
+				dependency.SrcAccess,
+				dependency.DstStages,
+				dependency.DstAccess,
+				dependency.CurrentLayout,
+				dependency.NewLayout,
+				dependency.SrcQueueFamily,
+				dependency.DstQueueFamily,
+				dependency.Image,
+				dependency.Range
+			});
+		}
+
+		VkDependencyInfoKHR dependencyInfo =
+		{
+			VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR,
+			nullptr,
+			0,
+			0,
+			nullptr,
+			static_cast<uint32_t>(bufferBarriers.size()),
+			bufferBarriers.size() > 0 ? &bufferBarriers[0] : nullptr,
+			static_cast<uint32_t>(imageBarriers.size()),
+			imageBarriers.size() > 0 ? &imageBarriers[0] : nullptr
+		};
+
+		mCmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+		return;
+	}
+
+	std::vector<VkBufferMemoryBarrier> bufferBarriers;
+	std::vector<VkImageMemoryBarrier> imageBarriers;
+	VkPipelineStageFlags generatingStages = 0;
+	VkPipelineStageFlags consumingStages = 0;
+
+	for (const auto& dependency : bufferDependencies)
+	{
+		generatingStages |= ToLegacyStages(dependency.SrcStages);
+		consumingStages |= ToLegacyStages(dependency.DstStages);
+
+		bufferBarriers.push_back({
+			VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+			nullptr,
+			ToLegacyAccess(dependency.SrcAccess),
+			ToLegacyAccess(dependency.DstAccess),
+			dependency.SrcQueueFamily,
+			dependency.DstQueueFamily,
+			dependency.Buffer,
+			dependency.Offset,
+			dependency.Size
+		});
+	}
+
+	for (const auto& dependency : imageDependencies)
+	{
+		generatingStages |= ToLegacyStages(dependency.SrcStages);
+		consumingStages |= ToLegacyStages(dependency.DstStages);
+
+		imageBarriers.push_back({
+			VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+			nullptr,
+			ToLegacyAccess(dependency.SrcAccess),
+			ToLegacyAccess(dependency.DstAccess),
+			dependency.CurrentLayout,
+			dependency.NewLayout,
+			dependency.SrcQueueFamily,
+			dependency.DstQueueFamily,
+			dependency.Image,
+			dependency.Range
+		});
+	}
+
+	vkCmdPipelineBarrier(
+		commandBuffer,
+		generatingStages == 0 ? VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT : generatingStages,
+		consumingStages == 0 ? VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT : consumingStages,
+		0,
+		0,
+		nullptr,
+		static_cast<uint32_t>(bufferBarriers.size()),
+		bufferBarriers.size() > 0 ? &bufferBarriers[0] : nullptr,
+		static_cast<uint32_t>(imageBarriers.size()),
+		imageBarriers.size() > 0 ? &imageBarriers[0] : nullptr
+	);
+}
+
+bool VulkanSample::CreateBufferView(VkBuffer buffer, 
+	VkFormat format, 
+	VkDeviceSize offset, 
+	VkDeviceSize size,
+	VkBufferView * view)
+{
+	VkResult result = VK_SUCCESS;
+
+	VkBufferViewCreateInfo createInfo =
+	{
+		VK_STRUCTURE_TYPE_BUFFER_VIEW_CREATE_INFO,
+		nullptr,
+		0,
+		buffer,
+		format,
+		offset,
+		size
+	};
+
+	result = vkCreateBufferView(
+		mDevice,
+		&createInfo,
+		nullptr,
+		view
+	);
+
+	if (result != VK_SUCCESS || *view == nullptr)
+	{
+		LOG_ERROR("Unable to create Buffer view");
+		return false;
+	}
+
+	mResourceStats.BufferViewCount++;
+
+	return true;
+}
+
+void VulkanSample::DestroyBufferView(VkBufferView view)
+{
+	if (view)
+	{
+		vkDestroyBufferView(mDevice, view, nullptr);
+		mResourceStats.BufferViewCount--;
+	}
+}
+
+bool VulkanSample::CreateImage(VkImageType type, 
+	bool cubemap, 
+	VkFormat format, 
+	VkExtent3D size, 
+	uint32_t numMipMaps, 
+	uint32_t numLayers, 
+	VkSampleCountFlagBits samples, 
+	VkImageUsageFlags usage,
+	VulkanMemoryUsage memoryUsage,
+	VulkanAllocation *allocation, 
+	VkImage * image)
+{
+	if (!CreateImageHandle(type, cubemap, format, size, numMipMaps, 
+		numLayers, samples, usage, image))
+		return false;
+
+	VkMemoryRequirements memoryRequirements;
+	bool dedicated = false;
+
+	GetImageMemoryRequirements(
+		*image,
+		&memoryRequirements,
+		&dedicated
+	);
+
+	uint32_t memoryTypeIndex = 0;
+
+	// lazily allocated memory is never sub-allocated, a device without it falls back to device local blocks
+	if (memoryUsage == VulkanMemoryUsage::GpuLazilyAllocated &&
+		mAllocator.FindMemoryTypeIndex(memoryRequirements.memoryTypeBits, memoryUsage, &memoryTypeIndex) &&
+		(mPhysicalDeviceMemoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & 
+			VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT))
+		dedicated = true;
+
+	bool allocated = dedicated ?
+		mAllocator.AllocateDedicated(memoryRequirements, memoryUsage, nullptr, *image, allocation) :
+		mAllocator.Allocate(memoryRequirements, memoryUsage, VulkanSuballocationType::Optimal, allocation);
+
+	if (!allocated)
+	{
+		LOG_ERROR("Unable to allocate memory for image");
+		DestroyImage(*image, { nullptr, 0, 0 });
+		*image = nullptr;
+		return false;
+	}
+
+	VkResult result = vkBindImageMemory(
+		mDevice,
+		*image,
+		allocation->Block->GetMemory(),
+		allocation->Offset
+	);
+
+	if (result != VK_SUCCESS)
+	{
+		LOG_ERROR("Unable to bind memory to image");
+		DestroyImage(*image, *allocation);
+		*image = nullptr;
+		*allocation = { nullptr, 0, 0 };
+		return false;
+	}
+
+	return true;
+}
+
+bool VulkanSample::CreateImageHandle(VkImageType type,
+	bool cubemap,
+	VkFormat format,
+	VkExtent3D size,
+	uint32_t numMipMaps,
+	uint32_t numLayers,
+	VkSampleCountFlagBits samples,
+	VkImageUsageFlags usage,
+	VkImage *image)
+{
+	VkResult result = VK_SUCCESS;
+
+	VkImageCreateInfo createInfo =
+	{
+		VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+		nullptr,
+		cubemap ? VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT : 0ul,
+		type,
+		format,
+		size,
+		numMipMaps,
+		cubemap ? numLayers * 6 : numLayers,
+		samples,
+		VK_IMAGE_TILING_OPTIMAL,
+		usage,
+		VK_SHARING_MODE_EXCLUSIVE,
+		0,
+		nullptr,
+		VK_IMAGE_LAYOUT_UNDEFINED
+	};
+
+	result = vkCreateImage(
+		mDevice,
+		&createInfo,
+		nullptr,
+		image
+	);
+
+	if (result != VK_SUCCESS || *image == nullptr)
+	{
+		LOG_ERROR("Unable to create image");
+		*image = nullptr;
+		return false;
+	}
+
+	mResourceStats.ImageCount++;
+
+	return true;
+}
+
+bool VulkanSample::CreateAliasedImage(VkImageType type,
+	VkFormat format,
+	VkExtent3D size,
+	uint32_t numMipMaps,
+	uint32_t numLayers,
+	VkSampleCountFlagBits samples,
+	VkImageUsageFlags usage,
+	VulkanAliasingPlanner &planner,
+	VulkanAliasedImage *aliasedImage)
+{
+	if (!CreateImageHandle(type, false, format, size, numMipMaps,
+		numLayers, samples, usage, &aliasedImage->Image))
+		return false;
+
+	VkMemoryRequirements memoryRequirements;
+
+	vkGetImageMemoryRequirements(
+		mDevice,
+		aliasedImage->Image,
+		&memoryRequirements
+	);
+
+	planner.AddImage(*aliasedImage, memoryRequirements);
+	return true;
+}
+
+bool VulkanSample::BindAliasedImages(VulkanAliasingPlanner &planner,
+	std::vector<VulkanAllocation> &allocations)
+{
+	if (!planner.Plan())
+		return false;
+
+	allocations.clear();
+
+	for (uint32_t group = 0; group < planner.GetGroupCount(); group++)
+	{
+		VulkanAllocation allocation;
+		VkMemoryRequirements memoryRequirements = planner.GetGroupMemoryRequirements(group);
+
+		bool allocated = memoryRequirements.size >= mDedicatedAllocationThreshold ?
+			mAllocator.AllocateDedicated(memoryRequirements, VulkanMemoryUsage::GpuOnly, 
+				nullptr, nullptr, &allocation) :
+			mAllocator.Allocate(memoryRequirements, VulkanMemoryUsage::GpuOnly, 
+				VulkanSuballocationType::Optimal, &allocation);
+
+		if (!allocated)
+		{
+			LOG_ERROR("Unable to allocate memory for aliasing group %d", group);
+			DestroyAliasedImages(planner, allocations);
+			return false;
+		}
+
+		allocations.push_back(allocation);
+	}
+
+	for (uint32_t index = 0; index < planner.GetImageCount(); index++)
+	{
+		uint32_t group = 0;
+		VkDeviceSize offset = 0;
+
+		planner.GetPlacement(index, &group, &offset);
+
+		VkResult result = vkBindImageMemory(
+			mDevice,
+			planner.GetImage(index).Image,
+			allocations[group].Block->GetMemory(),
+			allocations[group].Offset + offset
+		);
+
+		if (result != VK_SUCCESS)
+		{
+			LOG_ERROR("Unable to bind memory to aliased image");
+			DestroyAliasedImages(planner, allocations);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void VulkanSample::DestroyAliasedImages(VulkanAliasingPlanner &planner,
+	std::vector<VulkanAllocation> &allocations)
+{
+	for (uint32_t index = 0; index < planner.GetImageCount(); index++)
+	{
+		DestroyImage(planner.GetImage(index).Image, { nullptr, 0, 0 });
+	}
+
+	for (const VulkanAllocation &allocation : allocations)
+		mAllocator.Free(allocation);
+
+	allocations.clear();
+	planner.Clear();
+}
+
+void VulkanSample::DestroyImage(VkImage image, const VulkanAllocation &allocation)
+{
+	for (auto transient = mTransientAllocations.begin(); transient != mTransientAllocations.end(); ++transient)
+	{
+		if (transient->Block == allocation.Block)
+		{
+			mTransientAllocations.erase(transient);
+			break;
+		}
+	}
+
+	if (allocation.Block)
+		mAllocator.Free(allocation);
+
+	if (image)
+	{
+		vkDestroyImage(
+			mDevice, 
+			image, 
+			nullptr
+		);
+
+		mResourceStats.ImageCount--;
+	}
+}
+
+void VulkanSample::SetDedicatedAllocationThreshold(VkDeviceSize threshold)
+{
+	mDedicatedAllocationThreshold = threshold;
+}
+
+void VulkanSample::GetBufferMemoryRequirements(VkBuffer buffer,
+	VkMemoryRequirements *memoryRequirements,
+	bool *dedicated)
+{
+	if (!mDedicatedAllocationEnabled)
+	{
+		vkGetBufferMemoryRequirements(mDevice, buffer, memoryRequirements);
+		*dedicated = memoryRequirements->size >= mDedicatedAllocationThreshold;
+		return;
+	}
+
+	VkBufferMemoryRequirementsInfo2KHR requirementsInfo =
+	{
+		VK_STRUCTURE_TYPE_BUFFER_MEMORY_REQUIREMENTS_INFO_2_KHR,
+		nullptr,
+		buffer
+	};
+
+	VkMemoryDedicatedRequirementsKHR dedicatedRequirements =
+	{
+		VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS_KHR,
+		nullptr,
+		VK_FALSE,
+		VK_FALSE
+	};
+
+	VkMemoryRequirements2KHR requirements =
+	{
+		VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2_KHR,
+		&dedicatedRequirements
+	};
+
+	mGetBufferMemoryRequirements2(mDevice, &requirementsInfo, &requirements);
+
+	*memoryRequirements = requirements.memoryRequirements;
+	*dedicated = dedicatedRequirements.requiresDedicatedAllocation == VK_TRUE ||
+		dedicatedRequirements.prefersDedicatedAllocation == VK_TRUE ||
+		memoryRequirements->size >= mDedicatedAllocationThreshold;
+}
+
+void VulkanSample::GetImageMemoryRequirements(VkImage image,
+	VkMemoryRequirements *memoryRequirements,
+	bool *dedicated)
+{
+	if (!mDedicatedAllocationEnabled)
+	{
+		vkGetImageMemoryRequirements(mDevice, image, memoryRequirements);
+		*dedicated = memoryRequirements->size >= mDedicatedAllocationThreshold;
+		return;
+	}
+
+	VkImageMemoryRequirementsInfo2KHR requirementsInfo =
+	{
+		VK_STRUCTURE_TYPE_IMAGE_MEMORY_REQUIREMENTS_INFO_2_KHR,
+		nullptr,
+		image
+	};
+
+	VkMemoryDedicatedRequirementsKHR dedicatedRequirements =
+	{
+		VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS_KHR,
+		nullptr,
+		VK_FALSE,
+		VK_FALSE
+	};
+
+	VkMemoryRequirements2KHR requirements =
+	{
+		VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2_KHR,
+		&dedicatedRequirements
+	};
+
+	mGetImageMemoryRequirements2(mDevice, &requirementsInfo, &requirements);
+
+	*memoryRequirements = requirements.memoryRequirements;
+	*dedicated = dedicatedRequirements.requiresDedicatedAllocation == VK_TRUE ||
+		dedicatedRequirements.prefersDedicatedAllocation == VK_TRUE ||
+		memoryRequirements->size >= mDedicatedAllocationThreshold;
+}
+
+void VulkanSample::SetImagesMemoryBarrier(VkCommandBuffer commandBuffer, 
+	const std::vector<ImageMemoryTransition> &imageTransitions,
+	VkPipelineStageFlags generatingStages, 
+	VkPipelineStageFlags consumingStages)
+{
+	std::vector<VkImageMemoryBarrier> memoryBarriers;
+
+	for (uint32_t index = 0; index < static_cast<uint32_t>(imageTransitions.size()); index++)
+	{
+		memoryBarriers.push_back({
+			VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+			nullptr,
+			imageTransitions[index].CurrentAccess,
 			imageTransitions[index].NewAccess,
 			imageTransitions[index].CurrentLayout,
 			imageTransitions[index].NewLayout,
-			VK_QUEUE_FAMILY_IGNORED,
-			VK_QUEUE_FAMILY_IGNORED,
+			imageTransitions[index].SrcQueueFamily,
+			imageTransitions[index].DstQueueFamily,
 			imageTransitions[index].Image, 
 			{
 				imageTransitions[index].AspectFlags,
@@ -1385,80 +2987,621 @@ bool VulkanSample::CreateImageView(VkImage image, VkImageViewType type, VkFormat
 		}
 	};
 
-	result = vkCreateImageView(
-		mDevice,
-		&createInfo,
-		nullptr,
-		view
+	result = vkCreateImageView(
+		mDevice,
+		&createInfo,
+		nullptr,
+		view
+	);
+
+	if (result != VK_SUCCESS)
+	{
+		LOG_ERROR("Unable to create image view");
+		return false;
+	}
+
+	mResourceStats.ImageViewCount++;
+
+	return true;
+}
+
+void VulkanSample::DestroyImageView(VkImageView view)
+{
+	if (view)
+	{
+		vkDestroyImageView(
+			mDevice,
+			view,
+			nullptr
+		);
+
+		mResourceStats.ImageViewCount--;
+	}
+}
+
+bool VulkanSample::MapMemory(const VulkanAllocation &allocation, VkDeviceSize offset, VkDeviceSize size, void ** localData)
+{
+	void *allocationData = nullptr;
+
+	if (size != VK_WHOLE_SIZE && offset + size > allocation.Size)
+	{
+		LOG_ERROR("Map range exceeds allocation size");
+		return false;
+	}
+
+	if (!mAllocator.Map(allocation, &allocationData))
+	{
+		LOG_ERROR("Unable to Map memory");
+		return false;
+	}
+
+	*localData = static_cast<uint8_t*>(allocationData) + offset;
+	return true;
+}
+
+bool VulkanSample::UnmapMemory(const VulkanAllocation &allocation, VkDeviceSize offset, VkDeviceSize size)
+{
+	if (allocation.Block == nullptr)
+	{
+		LOG_ERROR("Unable to unmap unallocated memory");
+		return false;
+	}
+
+	mAllocator.AddFlushRange(allocation, offset, size);
+	return true;
+}
+
+void VulkanSample::InvalidateMemory(const VulkanAllocation &allocation, VkDeviceSize offset, VkDeviceSize size)
+{
+	mAllocator.AddInvalidateRange(allocation, offset, size);
+}
+
+bool VulkanSample::FlushMappedMemoryRanges()
+{
+	return mAllocator.FlushMappedRanges();
+}
+
+bool VulkanSample::InvalidateMappedMemoryRanges()
+{
+	return mAllocator.InvalidateMappedRanges();
+}
+
+bool VulkanSample::CreateStagingRing(VkDeviceSize size)
+{
+	return CreateStagingRing(size, &mStagingRing, &mStagingAllocation);
+}
+
+void VulkanSample::DestroyStagingRing()
+{
+	DestroyStagingRing(&mStagingRing, &mStagingAllocation);
+}
+
+bool VulkanSample::CreateStagingRing(VkDeviceSize size, 
+	VulkanStagingRing *ring, 
+	VulkanAllocation *allocation)
+{
+	VkBuffer buffer = nullptr;
+	void *mappedData = nullptr;
+
+	bool result = CreateBuffer(
+		VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+		size,
+		VulkanMemoryUsage::Upload,
+		&buffer,
+		allocation
+	);
+
+	if (!result)
+	{
+		LOG_ERROR("Unable to create Staging ring buffer");
+		return false;
+	}
+
+	if (!MapMemory(*allocation, 0, VK_WHOLE_SIZE, &mappedData) ||
+		!ring->Initialize(mDevice, buffer, mappedData, size))
+	{
+		LOG_ERROR("Unable to initialize Staging ring");
+		DestroyBuffer(buffer, *allocation);
+		*allocation = { nullptr, 0, 0 };
+		return false;
+	}
+
+	return true;
+}
+
+void VulkanSample::DestroyStagingRing(VulkanStagingRing *ring, 
+	VulkanAllocation *allocation)
+{
+	VkBuffer buffer = ring->GetBuffer();
+
+	ring->Destroy();
+	DestroyBuffer(buffer, *allocation);
+
+	*allocation = { nullptr, 0, 0 };
+}
+
+void VulkanSample::EndStagingFrame(VkFence fence)
+{
+	mStagingRing.EndFrame(fence);
+}
+
+bool VulkanSample::StageBufferData(VkCommandBuffer commandBuffer,
+	const void *data,
+	VkDeviceSize size,
+	VkBuffer buffer,
+	VkDeviceSize offset)
+{
+	return StageBufferData(mStagingRing, mStagingAllocation, commandBuffer,
+		data, size, buffer, offset);
+}
+
+bool VulkanSample::StageImageData(VkCommandBuffer commandBuffer,
+	const void *data,
+	VkDeviceSize size,
+	VkImage image,
+	VkImageLayout layout,
+	VkImageSubresourceLayers subresource,
+	VkOffset3D offset,
+	VkExtent3D extent)
+{
+	return StageImageData(mStagingRing, mStagingAllocation, commandBuffer,
+		data, size, image, layout, subresource, offset, extent);
+}
+
+bool VulkanSample::StageBufferData(VulkanStagingRing &ring,
+	const VulkanAllocation &ringAllocation,
+	VkCommandBuffer commandBuffer,
+	const void *data,
+	VkDeviceSize size,
+	VkBuffer buffer,
+	VkDeviceSize offset)
+{
+	VkDeviceSize stagingOffset = 0;
+	void *stagingData = nullptr;
+
+	if (!ring.Allocate(size, 16, &stagingOffset, &stagingData))
+	{
+		LOG_ERROR("Unable to allocate Staging memory for buffer");
+		return false;
+	}
+
+	memcpy(stagingData, data, static_cast<size_t>(size));
+	UnmapMemory(ringAllocation, stagingOffset, size);
+
+	VkBufferCopy region =
+	{
+		stagingOffset,
+		offset,
+		size
+	};
+
+	vkCmdCopyBuffer(
+		commandBuffer,
+		ring.GetBuffer(),
+		buffer,
+		1,
+		&region
+	);
+
+	return true;
+}
+
+bool VulkanSample::StageImageData(VulkanStagingRing &ring,
+	const VulkanAllocation &ringAllocation,
+	VkCommandBuffer commandBuffer,
+	const void *data,
+	VkDeviceSize size,
+	VkImage image,
+	VkImageLayout layout,
+	VkImageSubresourceLayers subresource,
+	VkOffset3D offset,
+	VkExtent3D extent)
+{
+	VkDeviceSize stagingOffset = 0;
+	void *stagingData = nullptr;
+	VkDeviceSize alignment = mPhysicalDeviceProperties.limits.optimalBufferCopyOffsetAlignment;
+
+	if (!ring.Allocate(size, alignment > 16 ? alignment : 16, 
+		&stagingOffset, &stagingData))
+	{
+		LOG_ERROR("Unable to allocate Staging memory for image");
+		return false;
+	}
+
+	memcpy(stagingData, data, static_cast<size_t>(size));
+	UnmapMemory(ringAllocation, stagingOffset, size);
+
+	VkBufferImageCopy region =
+	{
+		stagingOffset,
+		0,
+		0,
+		subresource,
+		offset,
+		extent
+	};
+
+	vkCmdCopyBufferToImage(
+		commandBuffer,
+		ring.GetBuffer(),
+		image,
+		layout,
+		1,
+		&region
+	);
+
+	return true;
+}
+
+bool VulkanSample::CreateUploadEngine(VkDeviceSize stagingSize, uint32_t batchCount)
+{
+	if (!mUploadCommandRecycler.Initialize(mDevice, 
+		GetQueueFamilyIndex(VulkanQueueType::Transfer), batchCount))
+	{
+		LOG_ERROR("Unable to create Upload command recycler");
+		return false;
+	}
+
+	if (!CreateStagingRing(stagingSize, &mUploadStagingRing, &mUploadStagingAllocation))
+	{
+		LOG_ERROR("Unable to create Upload staging ring");
+		mUploadCommandRecycler.Destroy();
+		return false;
+	}
+
+	mUploadBatches.resize(batchCount);
+
+	for (auto& batch : mUploadBatches)
+	{
+		batch.Fence = nullptr;
+		batch.Semaphore = nullptr;
+		batch.CommandBuffer = nullptr;
+		batch.Ticket = 0;
+		batch.DstStages = 0;
+		batch.Recording = false;
+		batch.Acquired = true;
+
+		if (!CreateFence(&batch.Fence, true) || !AcquireVulkanSemaphore(&batch.Semaphore))
+		{
+			LOG_ERROR("Unable to create Upload batch");
+			DestroyUploadEngine();
+			return false;
+		}
+	}
+
+	mUploadBatchIndex = 0;
+	return true;
+}
+
+void VulkanSample::DestroyUploadEngine()
+{
+	std::vector<VkFence> fences;
+
+	for (const auto& batch : mUploadBatches)
+	{
+		if (batch.Fence)
+			fences.push_back(batch.Fence);
+	}
+
+	WaitForFences(fences, true, UINT64_MAX);
+
+	for (const auto& batch : mUploadBatches)
+	{
+		ReleaseVulkanSemaphore(batch.Semaphore);
+		DestroyFence(batch.Fence);
+	}
+
+	mUploadBatches.clear();
+	mPendingUploadAcquires.clear();
+	mFrameUploadAcquires.clear();
+
+	if (mUploadStagingRing.GetBuffer())
+		DestroyStagingRing(&mUploadStagingRing, &mUploadStagingAllocation);
+
+	mUploadCommandRecycler.Destroy();
+}
+
+bool VulkanSample::BeginUploadBatch()
+{
+	UploadBatch &batch = mUploadBatches[mUploadBatchIndex];
+
+	if (batch.Recording)
+		return true;
+
+	if (!batch.Acquired)
+	{
+		LOG_ERROR("Upload engine is out of batches, previous uploads were not acquired yet");
+		return false;
+	}
+
+	if (mSubmitThread.IsRunning() && !CheckSubmitThreadResult())
+		return false;
+
+	if (WaitForFences({ batch.Fence }, true, UINT64_MAX) != VK_SUCCESS)
+		return false;
+
+	mFenceWatcher.Complete(batch.Fence);
+	mUploadStagingRing.RetireFrames();
+
+	if (!mUploadCommandRecycler.Reset(mUploadBatchIndex) ||
+		!mUploadCommandRecycler.Acquire(mUploadBatchIndex, 
+			VK_COMMAND_BUFFER_LEVEL_PRIMARY, &batch.CommandBuffer))
+		return false;
+
+	if (!BeginCommandBuffer(batch.CommandBuffer, VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+		VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, nullptr))
+		return false;
+
+	batch.DstStages = 0;
+	batch.BufferReleases.clear();
+	batch.ImageReleases.clear();
+	batch.BufferAcquires.clear();
+	batch.ImageAcquires.clear();
+	batch.Recording = true;
+
+	return true;
+}
+
+bool VulkanSample::UploadBufferData(const void *data,
+	VkDeviceSize size,
+	VkBuffer buffer,
+	VkDeviceSize offset,
+	VkAccessFlags dstAccess,
+	VkPipelineStageFlags dstStages)
+{
+	if (!BeginUploadBatch())
+		return false;
+
+	UploadBatch &batch = mUploadBatches[mUploadBatchIndex];
+
+	if (!StageBufferData(mUploadStagingRing, mUploadStagingAllocation, 
+		batch.CommandBuffer, data, size, buffer, offset))
+		return false;
+
+	uint32_t srcQueueFamily = GetQueueFamilyIndex(VulkanQueueType::Transfer);
+
+	if (srcQueueFamily != mQueueFamilyIndex)
+	{
+		batch.BufferReleases.push_back({ buffer, VK_ACCESS_TRANSFER_WRITE_BIT, 0, 
+			srcQueueFamily, mQueueFamilyIndex });
+		batch.BufferAcquires.push_back({ buffer, 0, dstAccess, 
+			srcQueueFamily, mQueueFamilyIndex });
+	}
+	else
+	{
+		batch.BufferReleases.push_back({ buffer, VK_ACCESS_TRANSFER_WRITE_BIT, dstAccess });
+	}
+
+	batch.DstStages |= dstStages;
+	return true;
+}
+
+bool VulkanSample::UploadImageData(const void *data,
+	VkDeviceSize size,
+	VkImage image,
+	VkImageSubresourceLayers subresource,
+	VkOffset3D offset,
+	VkExtent3D extent,
+	VkImageLayout currentLayout,
+	VkImageLayout finalLayout,
+	VkAccessFlags dstAccess,
+	VkPipelineStageFlags dstStages)
+{
+	uint32_t srcQueueFamily = GetQueueFamilyIndex(VulkanQueueType::Transfer);
+
+	// existing texels only survive on the transfer queue after a release from the graphics queue
+	if (currentLayout != VK_IMAGE_LAYOUT_UNDEFINED && srcQueueFamily != mQueueFamilyIndex)
+	{
+		LOG_ERROR("Unable to upload into initialized Image from the Transfer queue family");
+		return false;
+	}
+
+	if (!BeginUploadBatch())
+		return false;
+
+	UploadBatch &batch = mUploadBatches[mUploadBatchIndex];
+
+	VkImageSubresourceRange range =
+	{
+		subresource.aspectMask,
+		subresource.mipLevel,
+		1,
+		subresource.baseArrayLayer,
+		subresource.layerCount
+	};
+
+	if (dstStages == 0)
+		dstStages = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+	SetMemoryDependencies(
+		batch.CommandBuffer,
+		{},
+		{
+			{
+				image,
+				currentLayout == VK_IMAGE_LAYOUT_UNDEFINED ? 
+					VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT : VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+				currentLayout == VK_IMAGE_LAYOUT_UNDEFINED ? 
+					0 : VK_ACCESS_MEMORY_WRITE_BIT,
+				VK_PIPELINE_STAGE_TRANSFER_BIT,
+				VK_ACCESS_TRANSFER_WRITE_BIT,
+				currentLayout,
+				VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+				range
+			}
+		}
 	);
 
-	if (result != VK_SUCCESS)
-	{
-		LOG_ERROR("Unable to create image view");
+	if (!StageImageData(mUploadStagingRing, mUploadStagingAllocation, batch.CommandBuffer,
+		data, size, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, subresource, offset, extent))
 		return false;
+
+	if (srcQueueFamily != mQueueFamilyIndex)
+	{
+		batch.ImageReleases.push_back({ image, VK_PIPELINE_STAGE_TRANSFER_BIT, 
+			VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0,
+			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, finalLayout, range,
+			srcQueueFamily, mQueueFamilyIndex });
+		batch.ImageAcquires.push_back({ image, dstStages, 0, dstStages, dstAccess,
+			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, finalLayout, range,
+			srcQueueFamily, mQueueFamilyIndex });
+	}
+	else
+	{
+		batch.ImageReleases.push_back({ image, VK_PIPELINE_STAGE_TRANSFER_BIT, 
+			VK_ACCESS_TRANSFER_WRITE_BIT, dstStages, dstAccess,
+			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, finalLayout, range });
 	}
 
+	batch.DstStages |= dstStages;
 	return true;
 }
 
-void VulkanSample::DestroyImageView(VkImageView view)
+VulkanUploadTicket VulkanSample::SubmitUploads()
 {
-	if (view)
+	if (mUploadBatches.empty() || !mUploadBatches[mUploadBatchIndex].Recording)
+		return mUploadTicket;
+
+	UploadBatch &batch = mUploadBatches[mUploadBatchIndex];
+	bool ownershipTransfer = GetQueueFamilyIndex(VulkanQueueType::Transfer) != mQueueFamilyIndex;
+
+	if (batch.DstStages == 0)
+		batch.DstStages = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+	VkPipelineStageFlags releaseStages = ownershipTransfer ? 
+		VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT : batch.DstStages;
+
+	if (batch.BufferReleases.size() > 0)
 	{
-		vkDestroyImageView(
-			mDevice,
-			view,
-			nullptr
-		);
+		SetBuffersMemoryBarrier(batch.CommandBuffer, batch.BufferReleases,
+			VK_PIPELINE_STAGE_TRANSFER_BIT, releaseStages);
 	}
+
+	SetMemoryDependencies(batch.CommandBuffer, {}, batch.ImageReleases);
+
+	batch.Recording = false;
+
+	// reset only once the fence is certain to be submitted
+	if (!EndCommandBuffer(batch.CommandBuffer) || !FlushMappedMemoryRanges() || 
+		!ResetFences({ batch.Fence }))
+	{
+		mUploadStagingRing.DiscardFrame();
+		return 0;
+	}
+
+	uint32_t queueIndex = GetQueueIndex(VulkanQueueType::Transfer);
+
+	QueueSubmitCommandBuffers(queueIndex, 
+		{ batch.CommandBuffer }, 
+		{}, 
+		{}, 
+		{ batch.Semaphore }, 
+		batch.Fence);
+
+	bool submitted = FlushSubmits(queueIndex);
+
+	// the copies may already be queued, keep their staging memory until the fence signals
+	mUploadStagingRing.EndFrame(batch.Fence);
+
+	if (!submitted)
+		return 0;
+
+	batch.Ticket = ++mUploadTicket;
+	batch.Acquired = false;
+
+	mPendingUploadAcquires.push_back(mUploadBatchIndex);
+	mUploadBatchIndex = (mUploadBatchIndex + 1) % static_cast<uint32_t>(mUploadBatches.size());
+
+	return batch.Ticket;
 }
 
-bool VulkanSample::MapMemory(VkDeviceMemory memory, VkDeviceSize offset, VkDeviceSize size, void ** localData)
+VulkanSample::UploadBatch* VulkanSample::FindUploadBatch(VulkanUploadTicket ticket)
 {
-	VkResult result = vkMapMemory(
-		mDevice,
-		memory,
-		offset,
-		size,
-		0,
-		localData
-	);
-
-	if (result != VK_SUCCESS)
+	for (auto& batch : mUploadBatches)
 	{
-		LOG_ERROR("Unable to Map memory");
-		return false;
+		if (batch.Ticket == ticket)
+			return &batch;
 	}
 
-	return true;
+	return nullptr;
 }
 
-bool VulkanSample::UnmapMemory(VkDeviceMemory memory, VkDeviceSize offset, VkDeviceSize size)
+bool VulkanSample::IsUploadComplete(VulkanUploadTicket ticket)
 {
-	VkResult result = VK_SUCCESS;
+	if (ticket == 0)
+		return false;
 
-	VkMappedMemoryRange mappedRange =
-	{
-		VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
-		nullptr,
-		memory,
-		offset,
-		size
-	};
+	UploadBatch *batch = FindUploadBatch(ticket);
 
-	result = vkFlushMappedMemoryRanges(
-		mDevice,
-		1,
-		&mappedRange
-	);
+	if (batch == nullptr)
+		return ticket <= mUploadTicket;
 
-	if (result != VK_SUCCESS)
-	{
-		LOG_ERROR("Unable to flush mapped memory");
+	return vkGetFenceStatus(mDevice, batch->Fence) == VK_SUCCESS;
+}
+
+bool VulkanSample::WaitForUpload(VulkanUploadTicket ticket, uint64_t timeout)
+{
+	if (ticket == 0)
 		return false;
+
+	UploadBatch *batch = FindUploadBatch(ticket);
+
+	if (batch == nullptr)
+		return ticket <= mUploadTicket;
+
+	return WaitForFences({ batch->Fence }, true, timeout) == VK_SUCCESS;
+}
+
+std::future<VkResult> VulkanSample::WatchUpload(VulkanUploadTicket ticket,
+	const VulkanFenceWatcher::Callback &callback,
+	uint64_t timeout)
+{
+	UploadBatch *batch = ticket != 0 ? FindUploadBatch(ticket) : nullptr;
+
+	if (batch != nullptr)
+		return mFenceWatcher.Add(batch->Fence, callback, timeout);
+
+	VkResult result = ticket != 0 && ticket <= mUploadTicket ? VK_SUCCESS : VK_NOT_READY;
+	std::promise<VkResult> promise;
+
+	if (callback)
+		callback(result);
+
+	promise.set_value(result);
+	return promise.get_future();
+}
+
+void VulkanSample::AcquireUploads(VkCommandBuffer commandBuffer,
+	std::vector<VkSemaphore> &waitSemaphores,
+	std::vector<VkPipelineStageFlags> &waitStages)
+{
+	for (uint32_t batchIndex : mPendingUploadAcquires)
+	{
+		UploadBatch &batch = mUploadBatches[batchIndex];
+
+		if (batch.BufferAcquires.size() > 0)
+		{
+			SetBuffersMemoryBarrier(commandBuffer, batch.BufferAcquires,
+				batch.DstStages, batch.DstStages);
+		}
+
+		SetMemoryDependencies(commandBuffer, {}, batch.ImageAcquires);
+
+		waitSemaphores.push_back(batch.Semaphore);
+		waitStages.push_back(batch.DstStages);
+
+		mFrameUploadAcquires.push_back(batchIndex);
 	}
 
-	return true;
+	mPendingUploadAcquires.clear();
+}
+
+void VulkanSample::EndUploadAcquires()
+{
+	for (uint32_t batchIndex : mFrameUploadAcquires)
+		mUploadBatches[batchIndex].Acquired = true;
+
+	mFrameUploadAcquires.clear();
 }
 
 bool VulkanSample::CreateSampler(VkFilter magFilter, 
@@ -1528,7 +3671,7 @@ bool VulkanSample::CreateSampledImage(VkImageType type,
 	VkImageUsageFlags usage,
 	VkImageViewType viewType,
 	VkImageAspectFlags aspectFlags,
-	VkDeviceMemory * memory, 
+	VulkanAllocation * allocation, 
 	VkImage * image, 
 	VkImageView * view)
 {
@@ -1562,9 +3705,9 @@ bool VulkanSample::CreateSampledImage(VkImageType type,
 		numMipMaps,
 		numLayers,
 		VK_SAMPLE_COUNT_1_BIT,
-		usage | VK_IMAGE_USAGE_SAMPLED_BIT,
-		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-		memory,
+		usage | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+		VulkanMemoryUsage::GpuOnly,
+		allocation,
 		image
 	);
 
@@ -1585,7 +3728,7 @@ bool VulkanSample::CreateSampledImage(VkImageType type,
 	if (!result)
 	{
 		LOG_ERROR("Unable to create Sampled image view");
-		DestroyImage(*image, *memory);
+		DestroyImage(*image, *allocation);
 
 		return false;
 	}
@@ -1597,7 +3740,7 @@ bool VulkanSample::CreateUniformTexelBuffer(VkBufferUsageFlags usage,
 	VkFormat format,
 	VkDeviceSize size,
 	VkBuffer * buffer,
-	VkDeviceMemory * memory,
+	VulkanAllocation * allocation,
 	VkBufferView * view)
 {
 	VkFormatProperties formatProperties;
@@ -1616,9 +3759,9 @@ bool VulkanSample::CreateUniformTexelBuffer(VkBufferUsageFlags usage,
 	bool result = CreateBuffer(
 		usage | VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT,
 		size,
-		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+		VulkanMemoryUsage::GpuOnly,
 		buffer,
-		memory
+		allocation
 	);
 
 	if (!result)
@@ -1638,7 +3781,7 @@ bool VulkanSample::CreateUniformTexelBuffer(VkBufferUsageFlags usage,
 	if (!result)
 	{
 		LOG_ERROR("Unable to create Uniform Texel buffer view");
-		DestroyBuffer(*buffer, *memory);
+		DestroyBuffer(*buffer, *allocation);
 		return false;
 	}
 
@@ -1649,7 +3792,7 @@ bool VulkanSample::CreateStorageTexelBuffer(VkBufferUsageFlags usage,
 	VkFormat format,
 	VkDeviceSize size,
 	VkBuffer * buffer,
-	VkDeviceMemory * memory,
+	VulkanAllocation * allocation,
 	VkBufferView * view)
 {
 	VkFormatProperties formatProperties;
@@ -1668,9 +3811,9 @@ bool VulkanSample::CreateStorageTexelBuffer(VkBufferUsageFlags usage,
 	bool result = CreateBuffer(
 		usage | VK_BUFFER_USAGE_STORAGE_TEXEL_BUFFER_BIT,
 		size,
-		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+		VulkanMemoryUsage::GpuOnly,
 		buffer,
-		memory
+		allocation
 	);
 
 	if (!result)
@@ -1690,7 +3833,7 @@ bool VulkanSample::CreateStorageTexelBuffer(VkBufferUsageFlags usage,
 	if (!result)
 	{
 		LOG_ERROR("Unable to create Uniform Texel buffer view");
-		DestroyBuffer(*buffer, *memory);
+		DestroyBuffer(*buffer, *allocation);
 		return false;
 	}
 
@@ -1700,14 +3843,14 @@ bool VulkanSample::CreateStorageTexelBuffer(VkBufferUsageFlags usage,
 bool VulkanSample::CreateUniformBuffer(VkBufferUsageFlags usage,
 	VkDeviceSize size,
 	VkBuffer * buffer,
-	VkDeviceMemory * memory)
+	VulkanAllocation * allocation)
 {	
 	bool result = CreateBuffer(
-		usage | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+		usage | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
 		size,
-		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+		VulkanMemoryUsage::GpuOnly,
 		buffer,
-		memory
+		allocation
 	);
 
 	if (!result)
@@ -1722,14 +3865,14 @@ bool VulkanSample::CreateUniformBuffer(VkBufferUsageFlags usage,
 bool VulkanSample::CreateStorageBuffer(VkBufferUsageFlags usage,
 	VkDeviceSize size,
 	VkBuffer * buffer,
-	VkDeviceMemory * memory)
+	VulkanAllocation * allocation)
 {
 	bool result = CreateBuffer(
-		usage | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+		usage | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
 		size,
-		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+		VulkanMemoryUsage::GpuOnly,
 		buffer,
-		memory
+		allocation
 	);
 
 	if (!result)
@@ -1741,14 +3884,98 @@ bool VulkanSample::CreateStorageBuffer(VkBufferUsageFlags usage,
 	return true;
 }
 
+bool VulkanSample::CreateUniformArena(VkDeviceSize frameSize,
+	uint32_t frameCount,
+	VulkanBufferArena *arena,
+	VulkanAllocation *allocation)
+{
+	return CreateBufferArena(
+		VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+		frameSize,
+		frameCount,
+		mPhysicalDeviceProperties.limits.minUniformBufferOffsetAlignment,
+		arena,
+		allocation
+	);
+}
+
+bool VulkanSample::CreateStorageArena(VkDeviceSize frameSize,
+	uint32_t frameCount,
+	VulkanBufferArena *arena,
+	VulkanAllocation *allocation)
+{
+	return CreateBufferArena(
+		VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+		frameSize,
+		frameCount,
+		mPhysicalDeviceProperties.limits.minStorageBufferOffsetAlignment,
+		arena,
+		allocation
+	);
+}
+
+bool VulkanSample::CreateBufferArena(VkBufferUsageFlags usage,
+	VkDeviceSize frameSize,
+	uint32_t frameCount,
+	VkDeviceSize alignment,
+	VulkanBufferArena *arena,
+	VulkanAllocation *allocation)
+{
+	VkBuffer buffer = nullptr;
+	void *mappedData = nullptr;
+
+	VkDeviceSize alignedFrameSize = (frameSize + alignment - 1) / alignment * alignment;
+
+	bool result = CreateBuffer(
+		usage,
+		alignedFrameSize * frameCount,
+		VulkanMemoryUsage::Dynamic,
+		&buffer,
+		allocation
+	);
+
+	if (!result)
+	{
+		LOG_ERROR("Unable to create Buffer arena");
+		return false;
+	}
+
+	if (!MapMemory(*allocation, 0, VK_WHOLE_SIZE, &mappedData) ||
+		!arena->Initialize(buffer, mappedData, alignedFrameSize, frameCount, alignment))
+	{
+		LOG_ERROR("Unable to initialize Buffer arena");
+		DestroyBuffer(buffer, *allocation);
+		*allocation = { nullptr, 0, 0 };
+		return false;
+	}
+
+	return true;
+}
+
+void VulkanSample::DestroyBufferArena(VulkanBufferArena *arena, 
+	const VulkanAllocation &allocation)
+{
+	VkBuffer buffer = arena->GetBuffer();
+
+	arena->Destroy();
+	DestroyBuffer(buffer, allocation);
+}
+
+void VulkanSample::FlushBufferArena(const VulkanBufferArena &arena,
+	const VulkanAllocation &allocation)
+{
+	if (arena.GetUsedSize() > 0)
+		mAllocator.AddFlushRange(allocation, arena.GetFrameOffset(), arena.GetUsedSize());
+}
+
 bool VulkanSample::CreateInputAttachment(VkImageType type, 
 	VkFormat format, VkExtent3D size, 
 	VkImageUsageFlags usage, 
-	VkMemoryPropertyFlags propertyFlags, 
 	VkImageViewType viewType, 
 	VkImageAspectFlags aspectFlags, 
+	bool transient,
 	VkImage * image, 
-	VkDeviceMemory * memory,
+	VulkanAllocation * allocation,
 	VkImageView * view)
 {
 	VkFormatProperties formatProperties;
@@ -1776,6 +4003,17 @@ bool VulkanSample::CreateInputAttachment(VkImageType type,
 		}
 	}
 
+	VkImageUsageFlags attachmentUsage = 
+		VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+		VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+		VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+
+	if (transient && (usage & ~attachmentUsage))
+	{
+		LOG_ERROR("Transient input attachment supports attachment usage only");
+		return false;
+	}
+
 	bool result = CreateImage(
 		type,
 		false,
@@ -1784,9 +4022,11 @@ bool VulkanSample::CreateInputAttachment(VkImageType type,
 		1,
 		1,
 		VK_SAMPLE_COUNT_1_BIT,
-		usage | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT,
-		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-		memory,
+		transient ? 
+			usage | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT :
+			usage | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT,
+		transient ? VulkanMemoryUsage::GpuLazilyAllocated : VulkanMemoryUsage::GpuOnly,
+		allocation,
 		image
 	);
 
@@ -1796,6 +4036,20 @@ bool VulkanSample::CreateInputAttachment(VkImageType type,
 		return false;
 	}
 
+	if (transient)
+	{
+		if (mAllocator.GetMemoryPropertyFlags(*allocation) & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT)
+		{
+			mTransientAllocations.push_back(*allocation);
+			LOG_INFO("Transient input attachment uses lazily allocated memory (%" PRIu64 " bytes)", 
+				allocation->Size);
+		}
+		else
+		{
+			LOG_INFO("Lazily allocated memory unavailable, transient input attachment is committed");
+		}
+	}
+
 	result = CreateImageView(
 		*image,
 		viewType,
@@ -1807,9 +4061,258 @@ bool VulkanSample::CreateInputAttachment(VkImageType type,
 	if (!result)
 	{
 		LOG_ERROR("Unable to Create input attachment image view");
-		DestroyImage(*image, *memory);
+		DestroyImage(*image, *allocation);
+		return false;
+	}
+
+	return true;
+}
+
+VkDeviceSize VulkanSample::GetTransientMemorySaved()
+{
+	VkDeviceSize savedBytes = 0;
+
+	for (const auto& allocation : mTransientAllocations)
+	{
+		VkDeviceSize committedBytes = 0;
+
+		vkGetDeviceMemoryCommitment(
+			mDevice,
+			allocation.Block->GetMemory(),
+			&committedBytes
+		);
+
+		if (committedBytes < allocation.Size)
+			savedBytes += allocation.Size - committedBytes;
+	}
+
+	return savedBytes;
+}
+
+void VulkanSample::SetDeferredDestroyValue(uint64_t value)
+{
+	mDeferredDestroyValue = value;
+}
+
+void VulkanSample::QueueDestroyBuffer(VkBuffer buffer, const VulkanAllocation &allocation)
+{
+	QueueDestroy({ buffer, nullptr, nullptr, nullptr, allocation, nullptr });
+}
+
+void VulkanSample::QueueDestroyImage(VkImage image, const VulkanAllocation &allocation)
+{
+	QueueDestroy({ nullptr, image, nullptr, nullptr, allocation, nullptr });
+}
+
+void VulkanSample::QueueDestroyImageView(VkImageView view)
+{
+	QueueDestroy({ nullptr, nullptr, view, nullptr, { nullptr, 0, 0 }, nullptr });
+}
+
+void VulkanSample::QueueDestroyBufferView(VkBufferView view)
+{
+	QueueDestroy({ nullptr, nullptr, nullptr, view, { nullptr, 0, 0 }, nullptr });
+}
+
+void VulkanSample::QueueDestroySwapChain(VkSwapchainKHR swapChain)
+{
+	QueueDestroy({ nullptr, nullptr, nullptr, nullptr, { nullptr, 0, 0 }, swapChain });
+}
+
+void VulkanSample::RetireDeferredDestroys(uint64_t completedValue)
+{
+	while (!mDeferredDestroys.empty() && mDeferredDestroys.front().Value <= completedValue)
+	{
+		DestroyDeferred(mDeferredDestroys.front());
+		mDeferredDestroys.pop_front();
+	}
+
+	mSyncPool.RetireSemaphores(completedValue);
+}
+
+void VulkanSample::RetireDeferredDestroys(VkFence fence, uint64_t value)
+{
+	if (vkGetFenceStatus(mDevice, fence) == VK_SUCCESS)
+		RetireDeferredDestroys(value);
+}
+
+void VulkanSample::FlushDeferredDestroys()
+{
+	if (mDeferredDestroys.empty())
+		return;
+
+	WaitForSubmitToken(mSubmitToken);
+	vkDeviceWaitIdle(mDevice);
+	mSyncPool.RetireSemaphores(UINT64_MAX);
+
+	for (const auto& batch : mDeferredDestroys)
+		DestroyDeferred(batch);
+
+	mDeferredDestroys.clear();
+}
+
+void VulkanSample::QueueDestroy(const DeferredDestroy &destroy)
+{
+	if (mDeferredDestroys.empty() || mDeferredDestroys.back().Value != mDeferredDestroyValue)
+		mDeferredDestroys.push_back({ mDeferredDestroyValue, {} });
+
+	mDeferredDestroys.back().Destroys.push_back(destroy);
+}
+
+void VulkanSample::DestroyDeferred(const DeferredDestroyBatch &batch)
+{
+	for (const auto& destroy : batch.Destroys)
+	{
+		DestroyImageView(destroy.ImageView);
+		DestroyBufferView(destroy.BufferView);
+
+		if (destroy.SwapChain)
+			vkDestroySwapchainKHR(mDevice, destroy.SwapChain, nullptr);
+	}
+
+	for (const auto& destroy : batch.Destroys)
+	{
+		if (destroy.Buffer)
+			DestroyBuffer(destroy.Buffer, destroy.Allocation);
+		else if (destroy.Image)
+			DestroyImage(destroy.Image, destroy.Allocation);
+	}
+}
+
+void VulkanSample::GetMemoryStats(VulkanMemoryStats *stats)
+{
+	mAllocator.GetStats(stats);
+
+	if (!mMemoryBudgetEnabled)
+		return;
+
+	VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties =
+	{
+		VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT,
+		nullptr
+	};
+
+	VkPhysicalDeviceMemoryProperties2KHR memoryProperties =
+	{
+		VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2_KHR,
+		&budgetProperties
+	};
+
+	mGetPhysicalDeviceMemoryProperties2(mPhysicalDevice, &memoryProperties);
+
+	for (uint32_t heapIndex = 0; heapIndex < mPhysicalDeviceMemoryProperties.memoryHeapCount; heapIndex++)
+	{
+		stats->HeapBudget[heapIndex] = budgetProperties.heapBudget[heapIndex];
+		stats->HeapUsage[heapIndex] = budgetProperties.heapUsage[heapIndex];
+	}
+
+	stats->BudgetAvailable = true;
+}
+
+void VulkanSample::GetResourceStats(VulkanResourceStats *stats)
+{
+	*stats = mResourceStats;
+}
+
+static void WriteStatInfo(FILE *file, const VulkanMemoryStatInfo &info)
+{
+	fprintf(file, "\"blocks\": %u, \"allocations\": %u, \"blockBytes\": %" PRIu64 ", "
+		"\"allocationBytes\": %" PRIu64 ", \"largestFreeRange\": %" PRIu64,
+		info.BlockCount, info.AllocationCount, info.BlockBytes, 
+		info.AllocationBytes, info.LargestFreeRange);
+}
+
+bool VulkanSample::DumpMemoryStats(const std::string &fileName)
+{
+	FILE *file = nullptr;
+#ifdef _WIN32
+	errno_t err = fopen_s(&file, fileName.c_str(), "w");
+#else
+	file = fopen(fileName.c_str(), "w");
+	int err = file == nullptr ? errno : 0;
+#endif
+
+	if (err != 0 || file == nullptr)
+	{
+		LOG_ERROR("Unable to open memory stats file %s", fileName.c_str());
 		return false;
 	}
 
+	VulkanMemoryStats stats;
+	GetMemoryStats(&stats);
+
+	fprintf(file, "{\n\t\"resources\": { \"buffers\": %u, \"images\": %u, "
+		"\"bufferViews\": %u, \"imageViews\": %u },\n",
+		mResourceStats.BufferCount, mResourceStats.ImageCount,
+		mResourceStats.BufferViewCount, mResourceStats.ImageViewCount);
+
+	fprintf(file, "\t\"total\": { ");
+	WriteStatInfo(file, stats.Total);
+	fprintf(file, " },\n\t\"heaps\": [\n");
+
+	for (uint32_t heapIndex = 0; heapIndex < mPhysicalDeviceMemoryProperties.memoryHeapCount; heapIndex++)
+	{
+		fprintf(file, "\t\t{ \"index\": %u, \"size\": %" PRIu64 ", \"flags\": %u, ", heapIndex,
+			mPhysicalDeviceMemoryProperties.memoryHeaps[heapIndex].size,
+			mPhysicalDeviceMemoryProperties.memoryHeaps[heapIndex].flags);
+
+		WriteStatInfo(file, stats.MemoryHeaps[heapIndex]);
+
+		fprintf(file, ", \"budget\": %" PRIu64 ", \"usage\": %" PRIu64 ", \"driverReported\": %s }%s\n",
+			stats.HeapBudget[heapIndex], stats.HeapUsage[heapIndex],
+			stats.BudgetAvailable ? "true" : "false",
+			heapIndex + 1 < mPhysicalDeviceMemoryProperties.memoryHeapCount ? "," : "");
+	}
+
+	fprintf(file, "\t],\n\t\"types\": [\n");
+
+	for (uint32_t memoryType = 0; memoryType < mPhysicalDeviceMemoryProperties.memoryTypeCount; memoryType++)
+	{
+		fprintf(file, "\t\t{ \"index\": %u, \"heap\": %u, \"flags\": %u, ", memoryType,
+			mPhysicalDeviceMemoryProperties.memoryTypes[memoryType].heapIndex,
+			mPhysicalDeviceMemoryProperties.memoryTypes[memoryType].propertyFlags);
+
+		WriteStatInfo(file, stats.MemoryTypes[memoryType]);
+
+		fprintf(file, " }%s\n",
+			memoryType + 1 < mPhysicalDeviceMemoryProperties.memoryTypeCount ? "," : "");
+	}
+
+	fprintf(file, "\t]\n}\n");
+	fclose(file);
+
 	return true;
 }
+
+void VulkanSample::SetMemoryStatsInterval(uint32_t frameInterval)
+{
+	mMemoryStatsInterval = frameInterval;
+	mMemoryStatsFrame = 0;
+}
+
+void VulkanSample::UpdateMemoryStats()
+{
+	if (mMemoryStatsInterval == 0 || ++mMemoryStatsFrame < mMemoryStatsInterval)
+		return;
+
+	mMemoryStatsFrame = 0;
+
+	VulkanMemoryStats stats;
+	GetMemoryStats(&stats);
+
+	LOG_INFO("Memory: %u blocks, %u allocations, %" PRIu64 "/%" PRIu64 " bytes used, largest free %" PRIu64 ", "
+		"%u buffers, %u images",
+		stats.Total.BlockCount, stats.Total.AllocationCount,
+		stats.Total.AllocationBytes, stats.Total.BlockBytes,
+		stats.Total.LargestFreeRange,
+		mResourceStats.BufferCount, mResourceStats.ImageCount);
+
+	for (uint32_t heapIndex = 0; heapIndex < mPhysicalDeviceMemoryProperties.memoryHeapCount; heapIndex++)
+	{
+		if (stats.HeapUsage[heapIndex] > stats.HeapBudget[heapIndex])
+		{
+			LOG_WARN("Memory heap %u is over budget: %" PRIu64 " of %" PRIu64 " bytes", heapIndex,
+				stats.HeapUsage[heapIndex], stats.HeapBudget[heapIndex]);
+		}
+	}
+}
\ No newline at end of file
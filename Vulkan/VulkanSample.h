@@ -1,22 +1,43 @@
 #pragma once
 
+#ifdef _WIN32
 #define VK_USE_PLATFORM_WIN32_KHR
+#endif
 
+#include <chrono>
+#include <deque>
+#include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 #include <map>
+#ifdef _WIN32
 #include <Windows.h>
 #include <tchar.h>
-#include <vulkan\vulkan.h>
+#endif
+#include <vulkan/vulkan.h>
 
 #include "Logger.h"
-#include "VulkanWindow.h"
+#include "VulkanAliasingPlanner.h"
+#include "VulkanBufferArena.h"
+#include "VulkanCommandRecycler.h"
+#include "VulkanFenceWatcher.h"
+#include "VulkanFrameGraph.h"
+#include "VulkanMemoryAllocator.h"
+#include "VulkanPresentationBackend.h"
+#include "VulkanStagingRing.h"
+#include "VulkanSubmitBatcher.h"
+#include "VulkanSubmitThread.h"
+#include "VulkanSyncPool.h"
+#include "WorkerPool.h"
 
 struct BufferMemoryTransition
 {
 	VkBuffer Buffer;
 	VkAccessFlags CurrentAccess;
 	VkAccessFlags NewAccess;
+	uint32_t SrcQueueFamily = VK_QUEUE_FAMILY_IGNORED;
+	uint32_t DstQueueFamily = VK_QUEUE_FAMILY_IGNORED;
 };
 
 struct ImageMemoryTransition
@@ -27,11 +48,123 @@ struct ImageMemoryTransition
 	VkImageLayout CurrentLayout;
 	VkImageLayout NewLayout;
 	VkImageAspectFlags AspectFlags;
+	uint32_t SrcQueueFamily = VK_QUEUE_FAMILY_IGNORED;
+	uint32_t DstQueueFamily = VK_QUEUE_FAMILY_IGNORED;
+};
+
+struct BufferMemoryDependency
+{
+	VkBuffer Buffer;
+	VkPipelineStageFlags2KHR SrcStages;
+	VkAccessFlags2KHR SrcAccess;
+	VkPipelineStageFlags2KHR DstStages;
+	VkAccessFlags2KHR DstAccess;
+	VkDeviceSize Offset = 0;
+	VkDeviceSize Size = VK_WHOLE_SIZE;
+	uint32_t SrcQueueFamily = VK_QUEUE_FAMILY_IGNORED;
+	uint32_t DstQueueFamily = VK_QUEUE_FAMILY_IGNORED;
+};
+
+struct ImageMemoryDependency
+{
+	VkImage Image;
+	VkPipelineStageFlags2KHR SrcStages;
+	VkAccessFlags2KHR SrcAccess;
+	VkPipelineStageFlags2KHR DstStages;
+	VkAccessFlags2KHR DstAccess;
+	VkImageLayout CurrentLayout;
+	VkImageLayout NewLayout;
+	VkImageSubresourceRange Range;
+	uint32_t SrcQueueFamily = VK_QUEUE_FAMILY_IGNORED;
+	uint32_t DstQueueFamily = VK_QUEUE_FAMILY_IGNORED;
+};
+
+typedef uint64_t VulkanUploadTicket;
+
+enum class VulkanQueueType
+{
+	Graphics,
+	Compute,
+	Transfer
+};
+
+struct VulkanTimelineWait
+{
+	uint32_t QueueIndex;
+	uint64_t Value;
+	VkPipelineStageFlags Stages;
+};
+
+struct VulkanResourceStats
+{
+	uint32_t BufferCount;
+	uint32_t ImageCount;
+	uint32_t BufferViewCount;
+	uint32_t ImageViewCount;
+};
+
+struct VulkanFrameStats
+{
+	double CpuTime;
+	double WaitTime;
+	double FramesPerSecond;
+	uint64_t FrameCount;
+};
+
+struct DeferredDestroy
+{
+	VkBuffer Buffer;
+	VkImage Image;
+	VkImageView ImageView;
+	VkBufferView BufferView;
+	VulkanAllocation Allocation;
+	VkSwapchainKHR SwapChain;
 };
 
 class VulkanSample
 {
 private:
+
+	typedef std::chrono::high_resolution_clock Clock;
+
+	struct FrameContext
+	{
+		VkFence Fence;
+		VkSemaphore ImageAvailable;
+		VkCommandBuffer CommandBuffer;
+		uint64_t FrameNumber;
+		uint64_t SubmitToken;
+	};
+
+	struct QueueTimeline
+	{
+		VkSemaphore Semaphore;
+		uint64_t SubmittedValue;
+		uint64_t CompletedValue;
+		std::deque<std::pair<uint64_t, VkFence>> Fences;
+		std::deque<std::pair<uint64_t, VkSemaphore>> WaitSemaphores;
+	};
+
+	struct UploadBatch
+	{
+		VkFence Fence;
+		VkSemaphore Semaphore;
+		VkCommandBuffer CommandBuffer;
+		VulkanUploadTicket Ticket;
+		VkPipelineStageFlags DstStages;
+		std::vector<BufferMemoryTransition> BufferReleases;
+		std::vector<ImageMemoryDependency> ImageReleases;
+		std::vector<BufferMemoryTransition> BufferAcquires;
+		std::vector<ImageMemoryDependency> ImageAcquires;
+		bool Recording;
+		bool Acquired;
+	};
+
+	struct DeferredDestroyBatch
+	{
+		uint64_t Value;
+		std::vector<DeferredDestroy> Destroys;
+	};
 	
 	FileLogger								mLogger;
 	VkInstance								mVulkanInstance;
@@ -40,8 +173,15 @@ private:
 	VkPhysicalDeviceProperties				mPhysicalDeviceProperties;
 	VkPhysicalDeviceMemoryProperties		mPhysicalDeviceMemoryProperties;
 	uint32_t								mQueueFamilyIndex;
+	uint32_t								mComputeQueueFamilyIndex;
+	uint32_t								mTransferQueueFamilyIndex;
+	uint32_t								mTransferQueueFamilyOffset;
+	uint32_t								mComputeQueueIndex;
+	uint32_t								mTransferQueueIndex;
+	float									mComputeQueuePriority;
+	float									mTransferQueuePriority;
 	VkDevice								mDevice;
-	VulkanWindow							mWindow;
+	std::unique_ptr<VulkanPresentationBackend>	mPresentationBackend;
 	VkSurfaceKHR							mPresentationSurface;
 	VkPresentModeKHR						mPresentMode;
 	VkSurfaceCapabilitiesKHR				mPresentationSurfaceCapabilities;
@@ -50,16 +190,72 @@ private:
 	VkSurfaceFormatKHR						mPresentationSurfaceFormat;
 	VkSwapchainKHR							mOldSwapChain;
 	VkSwapchainKHR							mSwapChain;
+	bool									mSwapChainDirty;
 	VkCommandPool							mCommandPool;
+	VulkanCommandRecycler					mFrameCommandRecycler;
+	WorkerPool								mWorkerPool;
+	VulkanMemoryAllocator					mAllocator;
+	VulkanSyncPool							mSyncPool;
+	VulkanFenceWatcher						mFenceWatcher;
+	VulkanStagingRing						mStagingRing;
+	VulkanAllocation						mStagingAllocation;
+	bool									mDedicatedAllocationEnabled;
+	VkDeviceSize							mDedicatedAllocationThreshold;
+	std::vector<VulkanAllocation>			mTransientAllocations;
+	std::vector<std::unique_ptr<VulkanCommandRecycler>>	mThreadCommandRecyclers;
+	std::vector<FrameContext>				mFrameContexts;
+	uint32_t								mFrameIndex;
+	uint64_t								mFrameNumber;
+	uint32_t								mSwapChainImageIndex;
+	VulkanFrameStats						mFrameStats;
+	Clock::time_point						mFrameCpuStart;
+	Clock::time_point						mFrameStatsStart;
+	double									mFrameStatsCpuTime;
+	double									mFrameStatsWaitTime;
+	uint32_t								mFrameStatsFrames;
+	std::vector<VkSemaphore>				mFrameWaitSemaphores;
+	std::vector<VkPipelineStageFlags>		mFrameWaitStages;
+	VulkanCommandRecycler					mUploadCommandRecycler;
+	VulkanStagingRing						mUploadStagingRing;
+	VulkanAllocation						mUploadStagingAllocation;
+	std::vector<UploadBatch>				mUploadBatches;
+	uint32_t								mUploadBatchIndex;
+	VulkanUploadTicket						mUploadTicket;
+	std::vector<uint32_t>					mPendingUploadAcquires;
+	std::vector<uint32_t>					mFrameUploadAcquires;
+	std::deque<DeferredDestroyBatch>		mDeferredDestroys;
+	uint64_t								mDeferredDestroyValue;
+	VulkanResourceStats						mResourceStats;
+	uint32_t								mMemoryStatsInterval;
+	uint32_t								mMemoryStatsFrame;
+	bool									mProperties2Enabled;
+	bool									mMemoryBudgetEnabled;
+	bool									mTimelineSemaphoreEnabled;
+	bool									mSynchronization2Enabled;
+
+	PFN_vkGetPhysicalDeviceMemoryProperties2KHR	mGetPhysicalDeviceMemoryProperties2;
+	PFN_vkGetPhysicalDeviceFeatures2KHR		mGetPhysicalDeviceFeatures2;
+	PFN_vkWaitSemaphoresKHR					mWaitSemaphores;
+	PFN_vkGetSemaphoreCounterValueKHR		mGetSemaphoreCounterValue;
+	PFN_vkCmdPipelineBarrier2KHR			mCmdPipelineBarrier2;
+	PFN_vkQueueSubmit2KHR					mQueueSubmit2;
+
+	PFN_vkGetBufferMemoryRequirements2KHR	mGetBufferMemoryRequirements2;
+	PFN_vkGetImageMemoryRequirements2KHR	mGetImageMemoryRequirements2;
 	
 	std::vector<VkPhysicalDevice>			mDevices;
 	std::vector<VkExtensionProperties>		mInstanceExtensions;	
 	std::vector<VkExtensionProperties>		mDeviceExtensions;
 	std::vector<VkQueueFamilyProperties>	mQueueFamilyProperties;
 	std::vector<VkQueue>					mQueues;
+	std::vector<VulkanSubmitBatcher>		mSubmitBatchers;
+	VulkanSubmitThread						mSubmitThread;
+	uint64_t								mSubmitToken;
+	std::vector<QueueTimeline>				mQueueTimelines;
 	std::vector<VkPresentModeKHR>			mPresentModes;
 	std::vector<VkSurfaceFormatKHR>			mPresentationSurfaceFormats;
 	std::vector<VkImage>					mSwapChainImages;
+	std::vector<VkSemaphore>				mRenderFinishedSemaphores;
 	std::vector<VkFormat>					mFormats;
 
 public:
@@ -67,10 +263,55 @@ public:
 	VulkanSample();
 	~VulkanSample();
 
+	VkDevice GetDevice() const
+	{
+		return mDevice;
+	}
+
+	VkPhysicalDevice GetPhysicalDevice() const
+	{
+		return mPhysicalDevice;
+	}
+
+	VkImage GetCurrentSwapChainImage() const
+	{
+		return mSwapChainImages[mSwapChainImageIndex];
+	}
+
+	VkExtent2D GetSwapChainImageSize() const
+	{
+		return mSwapChainImageSize;
+	}
+
+	uint32_t GetFrameIndex() const
+	{
+		return mFrameIndex;
+	}
+
+	uint64_t GetFrameNumber() const
+	{
+		return mFrameNumber;
+	}
+
+	bool IsTimelineSemaphoreEnabled() const
+	{
+		return mTimelineSemaphoreEnabled;
+	}
+
+	bool IsSynchronization2Enabled() const
+	{
+		return mSynchronization2Enabled;
+	}
+
+	PFN_vkCmdPipelineBarrier2KHR GetCmdPipelineBarrier2() const
+	{
+		return mCmdPipelineBarrier2;
+	}
+
 	bool Initialize();
 	void Destroy();
 
-	bool CreateVulkanInstance(const std::vector<char*> &desiredExtensions);
+	bool CreateVulkanInstance(const std::vector<const char*> &desiredExtensions);
 	void DestroyVulkanInstance();
 
 	bool PopulateInstanceExtensions();
@@ -87,18 +328,30 @@ public:
 	bool SelectQueueFamily(VkQueueFlags desiredType, 
 		bool supportPresentation = true);
 
+	bool SelectAsyncQueueFamilies();
+	void SetQueuePriority(VulkanQueueType type, float priority);
+
+	bool HasDedicatedQueue(VulkanQueueType type) const;
+	uint32_t GetQueueFamilyIndex(VulkanQueueType type) const;
+	uint32_t GetQueueIndex(VulkanQueueType type) const;
+	VkQueue GetQueue(VulkanQueueType type) const;
+
 	bool CreateDevice(const std::vector<char*> &desiredExtensions, 
 		const std::vector<float> &desiredQueuePriorities);
 
 	void DestroyDevice();
 	bool GetQueues(uint32_t queueCount);
 
+	void SetPresentationBackend(std::unique_ptr<VulkanPresentationBackend> backend);
+	const char* GetPresentationSurfaceExtension() const;
+
 	bool CreateVulkanWindow(uint32_t width, 
 		uint32_t height, 
 		const std::string &title = "Vulkan Window");
 
 	void ShowVulkanWindow();
 	void DestroyVulkanWindow();
+	bool ProcessEvents();
 
 	bool CreatePresentationSurface();
 	void DestroyPresentationSurface();
@@ -110,6 +363,7 @@ public:
 	bool SelectPresentationSurfaceFormat(VkSurfaceFormatKHR surfaceFormat);
 
 	bool CreateSwapChain();
+	bool RecreateSwapChain();
 	void DestroySwapChain();
 
 	bool CreateCommandPool(VkCommandPoolCreateFlags createFlags);
@@ -122,6 +376,40 @@ public:
 
 	void FreeCommandBuffers(const std::vector<VkCommandBuffer> &buffers);
 
+	bool CreateFrameCommandRecycler(uint32_t frameCount);
+	void DestroyFrameCommandRecycler();
+	bool ResetFrameCommandBuffers(uint32_t frameIndex);
+
+	bool AcquireFrameCommandBuffer(uint32_t frameIndex,
+		VkCommandBufferLevel level,
+		VkCommandBuffer *buffer);
+
+	bool CreateFrameContexts(uint32_t frameCount);
+	void DestroyFrameContexts();
+
+	bool BeginFrame(VkCommandBuffer *commandBuffer);
+	bool EndFrame();
+
+	void GetFrameStats(VulkanFrameStats *stats);
+
+	bool CreateThreadCommandPools(uint32_t threadCount, uint32_t frameCount);
+	void DestroyThreadCommandPools();
+	bool ResetThreadCommandPools(uint32_t frameIndex);
+
+	VkCommandPool GetThreadCommandPool(uint32_t threadIndex, uint32_t frameIndex);
+
+	bool AcquireThreadCommandBuffer(uint32_t threadIndex, 
+		uint32_t frameIndex, 
+		VkCommandBuffer *buffer);
+
+	bool RecordSecondaryCommandBuffers(uint32_t frameIndex,
+		VkCommandBufferInheritanceInfo *inheritanceInfo,
+		const std::vector<std::function<void(VkCommandBuffer)>> &recorders,
+		std::vector<VkCommandBuffer> &buffers);
+
+	void ExecuteCommandBuffers(VkCommandBuffer primaryBuffer, 
+		const std::vector<VkCommandBuffer> &secondaryBuffers);
+
 	bool BeginCommandBuffer(VkCommandBuffer buffer, 
 		VkCommandBufferLevel level,
 		VkCommandBufferUsageFlags usage,
@@ -137,11 +425,23 @@ public:
 	bool CreateFence(VkFence *fence, bool isSignaled);
 	void DestroyFence(VkFence fence);
 
+	bool AcquireVulkanSemaphore(VkSemaphore *semaphore);
+	void ReleaseVulkanSemaphore(VkSemaphore semaphore);
+
+	bool AcquireFence(VkFence *fence);
+	void ReleaseFence(VkFence fence);
+
+	void GetSyncPoolStats(VulkanSyncPoolStats *stats) const;
+
 	bool ResetFences(const std::vector<VkFence> &fences);
-	bool WaitForFences(const std::vector<VkFence> &fences,
+	VkResult WaitForFences(const std::vector<VkFence> &fences,
 		bool waitForAll, 
 		uint64_t timeout);
 
+	std::future<VkResult> WatchFence(VkFence fence, 
+		const VulkanFenceWatcher::Callback &callback = nullptr,
+		uint64_t timeout = UINT64_MAX);
+
 	bool SubmitCommandBuffers(uint32_t queueIndex, 
 		const std::vector<VkCommandBuffer> &buffers,
 		const std::vector<VkSemaphore> &waitSemaphores,
@@ -149,13 +449,42 @@ public:
 		const std::vector<VkSemaphore> &signaledSemaphores,
 		VkFence fence);
 
+	void QueueSubmitCommandBuffers(uint32_t queueIndex,
+		const std::vector<VkCommandBuffer> &buffers,
+		const std::vector<VkSemaphore> &waitSemaphores,
+		const std::vector<VkPipelineStageFlags> &waitStates,
+		const std::vector<VkSemaphore> &signaledSemaphores,
+		VkFence fence);
+
+	bool FlushSubmits(uint32_t queueIndex);
+	bool FlushAllSubmits();
+
+	bool StartSubmitThread(uint32_t capacity = 256);
+	void StopSubmitThread();
+	bool IsSubmitThreadRunning() const;
+
+	uint64_t GetSubmitToken() const;
+	bool IsSubmitTokenComplete(uint64_t token) const;
+	void WaitForSubmitToken(uint64_t token);
+	void GetSubmitThreadStats(VulkanSubmitThreadStats *stats) const;
+
+	bool CreateQueueTimelines();
+	void DestroyQueueTimelines();
+
+	uint64_t QueueTimelineSubmit(uint32_t queueIndex,
+		const std::vector<VkCommandBuffer> &buffers,
+		const std::vector<VulkanTimelineWait> &waits);
+
+	uint64_t GetCompletedTimelineValue(uint32_t queueIndex);
+	bool WaitForTimeline(uint32_t queueIndex, uint64_t value, uint64_t timeout);
+
 	bool CreateBuffer(VkBufferUsageFlags usage,
 		VkDeviceSize size, 
-		VkMemoryPropertyFlags propertyFlags,
+		VulkanMemoryUsage memoryUsage,
 		VkBuffer *buffer,
-		VkDeviceMemory * memory);
+		VulkanAllocation *allocation);
 
-	void DestroyBuffer(VkBuffer buffer, VkDeviceMemory memory);
+	void DestroyBuffer(VkBuffer buffer, const VulkanAllocation &allocation);
 
 	void SetBuffersMemoryBarrier(VkCommandBuffer commandBuffer,
 		const std::vector<BufferMemoryTransition> &bufferTransitions,
@@ -178,17 +507,39 @@ public:
 		uint32_t numLayers, 
 		VkSampleCountFlagBits samples,
 		VkImageUsageFlags usage, 
-		VkMemoryPropertyFlags propertyFlags,
-		VkDeviceMemory *memory,
+		VulkanMemoryUsage memoryUsage,
+		VulkanAllocation *allocation,
 		VkImage *image);
 
-	void DestroyImage(VkImage image, VkDeviceMemory memory);
+	void DestroyImage(VkImage image, const VulkanAllocation &allocation);
+
+	bool CreateAliasedImage(VkImageType type,
+		VkFormat format,
+		VkExtent3D size,
+		uint32_t numMipMaps,
+		uint32_t numLayers,
+		VkSampleCountFlagBits samples,
+		VkImageUsageFlags usage,
+		VulkanAliasingPlanner &planner,
+		VulkanAliasedImage *aliasedImage);
+
+	bool BindAliasedImages(VulkanAliasingPlanner &planner,
+		std::vector<VulkanAllocation> &allocations);
+
+	void DestroyAliasedImages(VulkanAliasingPlanner &planner,
+		std::vector<VulkanAllocation> &allocations);
+
+	void SetDedicatedAllocationThreshold(VkDeviceSize threshold);
 
 	void SetImagesMemoryBarrier(VkCommandBuffer commandBuffer,
 		const std::vector<ImageMemoryTransition> &imageTransitions,
 		VkPipelineStageFlags generatingStages,
 		VkPipelineStageFlags consumingStages);
 
+	void SetMemoryDependencies(VkCommandBuffer commandBuffer,
+		const std::vector<BufferMemoryDependency> &bufferDependencies,
+		const std::vector<ImageMemoryDependency> &imageDependencies);
+
 	bool CreateImageView(VkImage image, 
 		VkImageViewType type, 
 		VkFormat format, 
@@ -197,12 +548,73 @@ public:
 
 	void DestroyImageView(VkImageView view);
 
-	bool MapMemory(VkDeviceMemory memory, VkDeviceSize offset, 
+	bool MapMemory(const VulkanAllocation &allocation, VkDeviceSize offset, 
 		VkDeviceSize size, void **localData);
 
-	bool UnmapMemory(VkDeviceMemory memory, VkDeviceSize offset,
+	bool UnmapMemory(const VulkanAllocation &allocation, VkDeviceSize offset,
+		VkDeviceSize size);
+
+	void InvalidateMemory(const VulkanAllocation &allocation, VkDeviceSize offset,
 		VkDeviceSize size);
 
+	bool FlushMappedMemoryRanges();
+	bool InvalidateMappedMemoryRanges();
+
+	bool CreateStagingRing(VkDeviceSize size);
+	void DestroyStagingRing();
+	void EndStagingFrame(VkFence fence);
+
+	bool StageBufferData(VkCommandBuffer commandBuffer,
+		const void *data,
+		VkDeviceSize size,
+		VkBuffer buffer,
+		VkDeviceSize offset);
+
+	bool StageImageData(VkCommandBuffer commandBuffer,
+		const void *data,
+		VkDeviceSize size,
+		VkImage image,
+		VkImageLayout layout,
+		VkImageSubresourceLayers subresource,
+		VkOffset3D offset,
+		VkExtent3D extent);
+
+	bool CreateUploadEngine(VkDeviceSize stagingSize, uint32_t batchCount);
+	void DestroyUploadEngine();
+
+	bool UploadBufferData(const void *data,
+		VkDeviceSize size,
+		VkBuffer buffer,
+		VkDeviceSize offset,
+		VkAccessFlags dstAccess,
+		VkPipelineStageFlags dstStages);
+
+	bool UploadImageData(const void *data,
+		VkDeviceSize size,
+		VkImage image,
+		VkImageSubresourceLayers subresource,
+		VkOffset3D offset,
+		VkExtent3D extent,
+		VkImageLayout currentLayout,
+		VkImageLayout finalLayout,
+		VkAccessFlags dstAccess,
+		VkPipelineStageFlags dstStages);
+
+	// completion covers the transfer queue only, the graphics queue acquire is recorded by the next BeginFrame
+	VulkanUploadTicket SubmitUploads();
+	bool IsUploadComplete(VulkanUploadTicket ticket);
+	bool WaitForUpload(VulkanUploadTicket ticket, uint64_t timeout);
+
+	std::future<VkResult> WatchUpload(VulkanUploadTicket ticket,
+		const VulkanFenceWatcher::Callback &callback = nullptr,
+		uint64_t timeout = UINT64_MAX);
+
+	void AcquireUploads(VkCommandBuffer commandBuffer,
+		std::vector<VkSemaphore> &waitSemaphores,
+		std::vector<VkPipelineStageFlags> &waitStages);
+
+	void EndUploadAcquires();
+
 	bool CreateSampler(VkFilter magFilter,
 		VkFilter minFilter,
 		VkSamplerMipmapMode mipMapMode,
@@ -230,7 +642,7 @@ public:
 		VkImageUsageFlags usage,
 		VkImageViewType viewType, 
 		VkImageAspectFlags aspectFlags,
-		VkDeviceMemory *memory,
+		VulkanAllocation *allocation,
 		VkImage *image,
 		VkImageView *view);
 
@@ -238,40 +650,159 @@ public:
 		VkFormat format,
 		VkDeviceSize size,
 		VkBuffer *buffer,
-		VkDeviceMemory *memory,
+		VulkanAllocation *allocation,
 		VkBufferView *view);
 
 	bool CreateStorageTexelBuffer(VkBufferUsageFlags usage,
 		VkFormat format,
 		VkDeviceSize size,
 		VkBuffer *buffer,
-		VkDeviceMemory *memory,
+		VulkanAllocation *allocation,
 		VkBufferView *view);
 
 	bool CreateUniformBuffer(VkBufferUsageFlags usage,
 		VkDeviceSize size,
 		VkBuffer *buffer,
-		VkDeviceMemory *memory);
+		VulkanAllocation *allocation);
 
 	bool CreateStorageBuffer(VkBufferUsageFlags usage,
 		VkDeviceSize size,
 		VkBuffer *buffer,
-		VkDeviceMemory *memory);
+		VulkanAllocation *allocation);
+
+	bool CreateUniformArena(VkDeviceSize frameSize,
+		uint32_t frameCount,
+		VulkanBufferArena *arena,
+		VulkanAllocation *allocation);
+
+	bool CreateStorageArena(VkDeviceSize frameSize,
+		uint32_t frameCount,
+		VulkanBufferArena *arena,
+		VulkanAllocation *allocation);
+
+	void DestroyBufferArena(VulkanBufferArena *arena, 
+		const VulkanAllocation &allocation);
+
+	void FlushBufferArena(const VulkanBufferArena &arena,
+		const VulkanAllocation &allocation);
 
 	bool CreateInputAttachment(VkImageType type,
 		VkFormat format,
 		VkExtent3D size,
 		VkImageUsageFlags usage,
-		VkMemoryPropertyFlags propertyFlags,
 		VkImageViewType viewType,
 		VkImageAspectFlags flags,
+		bool transient,
 		VkImage *image,
-		VkDeviceMemory *memory,
+		VulkanAllocation *allocation,
 		VkImageView *view);
 
+	VkDeviceSize GetTransientMemorySaved();
+
+	void SetDeferredDestroyValue(uint64_t value);
+
+	void QueueDestroyBuffer(VkBuffer buffer, const VulkanAllocation &allocation);
+	void QueueDestroyImage(VkImage image, const VulkanAllocation &allocation);
+	void QueueDestroyImageView(VkImageView view);
+	void QueueDestroyBufferView(VkBufferView view);
+	void QueueDestroySwapChain(VkSwapchainKHR swapChain);
+
+	void RetireDeferredDestroys(uint64_t completedValue);
+	void RetireDeferredDestroys(VkFence fence, uint64_t value);
+	void FlushDeferredDestroys();
+
+	void GetMemoryStats(VulkanMemoryStats *stats);
+	void GetResourceStats(VulkanResourceStats *stats);
+	bool DumpMemoryStats(const std::string &fileName);
+
+	void SetMemoryStatsInterval(uint32_t frameInterval);
+	void UpdateMemoryStats();
+
 private:
 
 	bool IsInstanceExtensionSupported(const std::string &extension);
 	bool IsDeviceExtensionSupported(const std::string &extension);
 	bool IsQueueFamilySupportsPresentation(uint32_t index);
+
+	uint32_t FindQueueFamily(VkQueueFlags requiredFlags, 
+		VkQueueFlags excludedFlags);
+
+	bool CreateImageHandle(VkImageType type,
+		bool cubemap,
+		VkFormat format,
+		VkExtent3D size,
+		uint32_t numMipMaps,
+		uint32_t numLayers,
+		VkSampleCountFlagBits samples,
+		VkImageUsageFlags usage,
+		VkImage *image);
+
+	bool CreateBufferArena(VkBufferUsageFlags usage,
+		VkDeviceSize frameSize,
+		uint32_t frameCount,
+		VkDeviceSize alignment,
+		VulkanBufferArena *arena,
+		VulkanAllocation *allocation);
+
+	void UpdateFrameStats(double waitTime, double cpuTime);
+
+	bool CreateTimelineSemaphore(VkSemaphore *semaphore);
+
+	void AddSubmit(uint32_t queueIndex,
+		const std::vector<VkCommandBuffer> &buffers,
+		const std::vector<VkSemaphore> &waitSemaphores,
+		const std::vector<VkPipelineStageFlags> &waitStages,
+		const std::vector<VkSemaphore> &signalSemaphores,
+		VkFence fence,
+		const std::vector<uint64_t> &waitValues = {},
+		const std::vector<uint64_t> &signalValues = {});
+
+	bool UpdatePresentationSurfaceCapabilities();
+	bool CreateRenderFinishedSemaphores();
+	void ReleaseRenderFinishedSemaphores();
+	uint64_t BeginSwapChainAcquire(VkSemaphore semaphore);
+	VkResult EndSwapChainAcquire(uint64_t token, VkSemaphore semaphore);
+	bool CheckPresentResult(VkResult result);
+	bool CheckSubmitThreadResult();
+	VkResult PresentSwapChainImage(const std::vector<VkSemaphore> &waitSemaphores);
+
+	bool CreateStagingRing(VkDeviceSize size,
+		VulkanStagingRing *ring,
+		VulkanAllocation *allocation);
+
+	void DestroyStagingRing(VulkanStagingRing *ring,
+		VulkanAllocation *allocation);
+
+	bool StageBufferData(VulkanStagingRing &ring,
+		const VulkanAllocation &ringAllocation,
+		VkCommandBuffer commandBuffer,
+		const void *data,
+		VkDeviceSize size,
+		VkBuffer buffer,
+		VkDeviceSize offset);
+
+	bool StageImageData(VulkanStagingRing &ring,
+		const VulkanAllocation &ringAllocation,
+		VkCommandBuffer commandBuffer,
+		const void *data,
+		VkDeviceSize size,
+		VkImage image,
+		VkImageLayout layout,
+		VkImageSubresourceLayers subresource,
+		VkOffset3D offset,
+		VkExtent3D extent);
+
+	bool BeginUploadBatch();
+	UploadBatch* FindUploadBatch(VulkanUploadTicket ticket);
+
+	void QueueDestroy(const DeferredDestroy &destroy);
+	void DestroyDeferred(const DeferredDestroyBatch &batch);
+
+	void GetBufferMemoryRequirements(VkBuffer buffer,
+		VkMemoryRequirements *memoryRequirements,
+		bool *dedicated);
+
+	void GetImageMemoryRequirements(VkImage image,
+		VkMemoryRequirements *memoryRequirements,
+		bool *dedicated);
 };
\ No newline at end of file
@@ -0,0 +1,184 @@
+#include "VulkanStagingRing.h"
+#include "Logger.h"
+#include <cinttypes>
+
+static VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment)
+{
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+VulkanStagingRing::VulkanStagingRing()
+	: mDevice(nullptr),
+	mBuffer(nullptr),
+	mMappedData(nullptr),
+	mSize(0),
+	mHead(0),
+	mTail(0),
+	mFrameHasAllocations(false)
+{
+}
+
+VulkanStagingRing::~VulkanStagingRing()
+{
+	Destroy();
+}
+
+bool VulkanStagingRing::Initialize(VkDevice device, VkBuffer buffer,
+	void *mappedData, VkDeviceSize size)
+{
+	if (device == nullptr || buffer == nullptr || mappedData == nullptr || size == 0)
+	{
+		LOG_ERROR("Invalid staging ring parameters");
+		return false;
+	}
+
+	mDevice = device;
+	mBuffer = buffer;
+	mMappedData = static_cast<uint8_t*>(mappedData);
+	mSize = size;
+	mHead = 0;
+	mTail = 0;
+	mFrameHasAllocations = false;
+	mFrames.clear();
+
+	return true;
+}
+
+void VulkanStagingRing::Destroy()
+{
+	mFrames.clear();
+
+	mDevice = nullptr;
+	mBuffer = nullptr;
+	mMappedData = nullptr;
+	mSize = 0;
+	mHead = 0;
+	mTail = 0;
+	mFrameHasAllocations = false;
+}
+
+bool VulkanStagingRing::Allocate(VkDeviceSize size,
+	VkDeviceSize alignment,
+	VkDeviceSize *offset,
+	void **data)
+{
+	if (alignment == 0)
+		alignment = 1;
+
+	if (size == 0 || size > mSize)
+	{
+		LOG_ERROR("Invalid staging allocation size %" PRIu64, size);
+		return false;
+	}
+
+	bool result = TryAllocate(size, alignment, offset);
+
+	if (!result)
+	{
+		RetireFrames();
+		result = TryAllocate(size, alignment, offset);
+	}
+
+	while (!result && !mFrames.empty())
+	{
+		VkResult waitResult = vkWaitForFences(
+			mDevice,
+			1,
+			&mFrames.front().Fence,
+			VK_TRUE,
+			UINT64_MAX
+		);
+
+		if (waitResult != VK_SUCCESS)
+		{
+			LOG_ERROR("Waiting for staging ring frame failed");
+			return false;
+		}
+
+		mTail = mFrames.front().End;
+		mFrames.pop_front();
+
+		result = TryAllocate(size, alignment, offset);
+	}
+
+	if (!result)
+	{
+		LOG_ERROR("Staging ring is out of space");
+		return false;
+	}
+
+	*data = mMappedData + *offset;
+	return true;
+}
+
+void VulkanStagingRing::EndFrame(VkFence fence)
+{
+	if (!mFrameHasAllocations)
+		return;
+
+	mFrames.push_back({ fence, mHead });
+	mFrameHasAllocations = false;
+}
+
+void VulkanStagingRing::DiscardFrame()
+{
+	if (!mFrameHasAllocations)
+		return;
+
+	mHead = mFrames.empty() ? mTail : mFrames.back().End;
+	mFrameHasAllocations = false;
+}
+
+void VulkanStagingRing::RetireFrames()
+{
+	while (!mFrames.empty())
+	{
+		if (vkGetFenceStatus(mDevice, mFrames.front().Fence) != VK_SUCCESS)
+			break;
+
+		mTail = mFrames.front().End;
+		mFrames.pop_front();
+	}
+}
+
+bool VulkanStagingRing::IsEmpty() const
+{
+	return mFrames.empty() && !mFrameHasAllocations;
+}
+
+bool VulkanStagingRing::TryAllocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize *offset)
+{
+	if (IsEmpty())
+	{
+		mHead = 0;
+		mTail = 0;
+	}
+
+	VkDeviceSize start = AlignUp(mHead, alignment);
+
+	if (mHead > mTail || IsEmpty())
+	{
+		if (start + size > mSize)
+		{
+			if (size > mTail)
+				return false;
+
+			start = 0;
+		}
+	}
+	else if (mHead < mTail)
+	{
+		if (start + size > mTail)
+			return false;
+	}
+	else
+	{
+		return false;
+	}
+
+	*offset = start;
+	mHead = start + size;
+	mFrameHasAllocations = true;
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <deque>
+#include <vulkan/vulkan.h>
+
+class VulkanStagingRing
+{
+private:
+
+	struct Frame
+	{
+		VkFence Fence;
+		VkDeviceSize End;
+	};
+
+	VkDevice					mDevice;
+	VkBuffer					mBuffer;
+	uint8_t						*mMappedData;
+	VkDeviceSize				mSize;
+	VkDeviceSize				mHead;
+	VkDeviceSize				mTail;
+	bool						mFrameHasAllocations;
+
+	std::deque<Frame>			mFrames;
+
+public:
+
+	VulkanStagingRing();
+	~VulkanStagingRing();
+
+	VkBuffer GetBuffer() const
+	{
+		return mBuffer;
+	}
+
+	VkDeviceSize GetSize() const
+	{
+		return mSize;
+	}
+
+	bool Initialize(VkDevice device, VkBuffer buffer,
+		void *mappedData, VkDeviceSize size);
+
+	void Destroy();
+
+	bool Allocate(VkDeviceSize size,
+		VkDeviceSize alignment,
+		VkDeviceSize *offset,
+		void **data);
+
+	void EndFrame(VkFence fence);
+	void DiscardFrame();
+	void RetireFrames();
+
+private:
+
+	bool IsEmpty() const;
+	bool TryAllocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize *offset);
+};
\ No newline at end of file
@@ -0,0 +1,485 @@
+#include "VulkanStateTracker.h"
+#include "Logger.h"
+
+static const VkAccessFlags WriteAccessMask =
+	VK_ACCESS_SHADER_WRITE_BIT |
+	VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+	VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+	VK_ACCESS_TRANSFER_WRITE_BIT |
+	VK_ACCESS_HOST_WRITE_BIT |
+	VK_ACCESS_MEMORY_WRITE_BIT;
+
+VulkanStateTracker::VulkanStateTracker()
+	: mCommandBuffer(nullptr),
+	mCmdPipelineBarrier2(nullptr),
+	mSrcStages(0),
+	mDstStages(0),
+	mStats({})
+{
+}
+
+VulkanStateTracker::~VulkanStateTracker()
+{
+}
+
+void VulkanStateTracker::SetSynchronization2(PFN_vkCmdPipelineBarrier2KHR cmdPipelineBarrier2)
+{
+	mCmdPipelineBarrier2 = cmdPipelineBarrier2;
+}
+
+void VulkanStateTracker::Begin(VkCommandBuffer commandBuffer)
+{
+	mCommandBuffer = commandBuffer;
+	mBufferBarriers.clear();
+	mImageBarriers.clear();
+	mBufferStages.clear();
+	mImageStages.clear();
+	mSrcStages = 0;
+	mDstStages = 0;
+}
+
+void VulkanStateTracker::Reset()
+{
+	Begin(nullptr);
+
+	mBuffers.clear();
+	mImages.clear();
+	mStats = {};
+}
+
+void VulkanStateTracker::TrackImage(VkImage image,
+	VkImageAspectFlags aspectFlags,
+	uint32_t mipLevels,
+	uint32_t arrayLayers,
+	VkImageLayout layout,
+	VkAccessFlags access,
+	VkPipelineStageFlags stages)
+{
+	State state = { 0, 0, 0, 0, layout };
+
+	if (access & WriteAccessMask)
+	{
+		state.WriteStages = stages;
+		state.WriteAccess = access;
+	}
+	else
+	{
+		state.ReadStages = stages;
+		state.ReadAccess = access;
+	}
+
+	ImageState &imageState = mImages[image];
+
+	imageState.AspectFlags = aspectFlags;
+	imageState.MipLevels = mipLevels;
+	imageState.ArrayLayers = arrayLayers;
+	imageState.Subresources.assign(mipLevels * arrayLayers, state);
+}
+
+void VulkanStateTracker::UseBuffer(VkBuffer buffer,
+	VkDeviceSize offset,
+	VkDeviceSize size,
+	VkAccessFlags access,
+	VkPipelineStageFlags stages)
+{
+	auto& ranges = mBuffers[buffer];
+	VkDeviceSize end = size == VK_WHOLE_SIZE ? UINT64_MAX : offset + size;
+
+	if (HasPendingBarrier(buffer, offset, end))
+		Flush();
+
+	SplitBufferRange(ranges, offset);
+	SplitBufferRange(ranges, end);
+
+	VkDeviceSize position = offset;
+
+	while (position < end)
+	{
+		auto it = ranges.find(position);
+
+		if (it == ranges.end())
+		{
+			auto next = ranges.lower_bound(position);
+			VkDeviceSize gapEnd = next == ranges.end() || next->first > end ? end : next->first;
+
+			it = ranges.insert({ position, { gapEnd - position, { 0, 0, 0, 0, VK_IMAGE_LAYOUT_UNDEFINED } } }).first;
+		}
+
+		VkAccessFlags srcAccess = 0;
+		StagePair barrierStages;
+
+		if (Transition(it->second.RangeState, VK_IMAGE_LAYOUT_UNDEFINED, access, stages, 
+			&srcAccess, &barrierStages))
+		{
+			VkDeviceSize rangeSize = it->first + it->second.Size == UINT64_MAX ?
+				VK_WHOLE_SIZE : it->second.Size;
+
+			if (mBufferBarriers.size() > 0 &&
+				mBufferBarriers.back().buffer == buffer &&
+				mBufferBarriers.back().srcAccessMask == srcAccess &&
+				mBufferBarriers.back().dstAccessMask == access &&
+				mBufferStages.back().second == barrierStages.second &&
+				mBufferBarriers.back().size != VK_WHOLE_SIZE &&
+				mBufferBarriers.back().offset + mBufferBarriers.back().size == it->first)
+			{
+				mBufferBarriers.back().size = rangeSize == VK_WHOLE_SIZE ? 
+					VK_WHOLE_SIZE : mBufferBarriers.back().size + rangeSize;
+
+				mBufferStages.back().first |= barrierStages.first;
+			}
+			else
+			{
+				mBufferBarriers.push_back({
+					VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+					nullptr,
+					srcAccess,
+					access,
+					VK_QUEUE_FAMILY_IGNORED,
+					VK_QUEUE_FAMILY_IGNORED,
+					buffer,
+					it->first,
+					rangeSize
+				});
+
+				mBufferStages.push_back(barrierStages);
+			}
+		}
+
+		position = it->first + it->second.Size;
+	}
+}
+
+void VulkanStateTracker::UseImage(VkImage image,
+	const VkImageSubresourceRange &range,
+	VkImageLayout layout,
+	VkAccessFlags access,
+	VkPipelineStageFlags stages)
+{
+	auto it = mImages.find(image);
+
+	if (it == mImages.end())
+	{
+		LOG_ERROR("Image is not tracked");
+		return;
+	}
+
+	ImageState &imageState = it->second;
+
+	uint32_t levelCount = range.levelCount == VK_REMAINING_MIP_LEVELS ?
+		imageState.MipLevels - range.baseMipLevel : range.levelCount;
+
+	uint32_t layerCount = range.layerCount == VK_REMAINING_ARRAY_LAYERS ?
+		imageState.ArrayLayers - range.baseArrayLayer : range.layerCount;
+
+	if (range.baseMipLevel + levelCount > imageState.MipLevels ||
+		range.baseArrayLayer + layerCount > imageState.ArrayLayers)
+	{
+		LOG_ERROR("Image subresource range is out of bounds");
+		return;
+	}
+
+	if (HasPendingBarrier(image, range.baseMipLevel, levelCount, range.baseArrayLayer, layerCount))
+		Flush();
+
+	size_t firstBarrier = mImageBarriers.size();
+
+	for (uint32_t mipLevel = range.baseMipLevel; mipLevel < range.baseMipLevel + levelCount; mipLevel++)
+	{
+		for (uint32_t arrayLayer = range.baseArrayLayer; arrayLayer < range.baseArrayLayer + layerCount; arrayLayer++)
+		{
+			State &state = imageState.Subresources[mipLevel * imageState.ArrayLayers + arrayLayer];
+			VkImageLayout oldLayout = state.Layout;
+			VkAccessFlags srcAccess = 0;
+			StagePair barrierStages;
+
+			if (!Transition(state, layout, access, stages, &srcAccess, &barrierStages))
+				continue;
+
+			VkImageSubresourceRange subresource =
+			{
+				imageState.AspectFlags,
+				mipLevel,
+				1,
+				arrayLayer,
+				1
+			};
+
+			if (mImageBarriers.size() > firstBarrier)
+			{
+				VkImageMemoryBarrier &last = mImageBarriers.back();
+
+				if (
+					last.srcAccessMask == srcAccess &&
+					last.oldLayout == oldLayout &&
+					last.newLayout == layout &&
+					last.subresourceRange.baseMipLevel == mipLevel &&
+					last.subresourceRange.levelCount == 1 &&
+					last.subresourceRange.baseArrayLayer + last.subresourceRange.layerCount == arrayLayer)
+				{
+					last.subresourceRange.layerCount++;
+					mImageStages.back().first |= barrierStages.first;
+					continue;
+				}
+			}
+
+			mImageBarriers.push_back({
+				VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+				nullptr,
+				srcAccess,
+				access,
+				oldLayout,
+				layout,
+				VK_QUEUE_FAMILY_IGNORED,
+				VK_QUEUE_FAMILY_IGNORED,
+				image,
+				subresource
+			});
+
+			mImageStages.push_back(barrierStages);
+		}
+	}
+
+	MergeMipLevels(firstBarrier);
+}
+
+void VulkanStateTracker::Flush()
+{
+	if (mBufferBarriers.empty() && mImageBarriers.empty())
+		return;
+
+	if (mCmdPipelineBarrier2)
+		Flush2();
+	else
+		vkCmdPipelineBarrier(
+			mCommandBuffer,
+			mSrcStages,
+			mDstStages,
+			0,
+			0,
+			nullptr,
+			static_cast<uint32_t>(mBufferBarriers.size()),
+			mBufferBarriers.size() > 0 ? &mBufferBarriers[0] : nullptr,
+			static_cast<uint32_t>(mImageBarriers.size()),
+			mImageBarriers.size() > 0 ? &mImageBarriers[0] : nullptr
+		);
+
+	mStats.BarrierCalls++;
+	mStats.BufferBarriers += static_cast<uint32_t>(mBufferBarriers.size());
+	mStats.ImageBarriers += static_cast<uint32_t>(mImageBarriers.size());
+
+	mBufferBarriers.clear();
+	mImageBarriers.clear();
+	mBufferStages.clear();
+	mImageStages.clear();
+	mSrcStages = 0;
+	mDstStages = 0;
+}
+
+VkImageLayout VulkanStateTracker::GetImageLayout(VkImage image, uint32_t mipLevel, uint32_t arrayLayer) const
+{
+	auto it = mImages.find(image);
+
+	if (it == mImages.end() || mipLevel >= it->second.MipLevels || arrayLayer >= it->second.ArrayLayers)
+		return VK_IMAGE_LAYOUT_UNDEFINED;
+
+	return it->second.Subresources[mipLevel * it->second.ArrayLayers + arrayLayer].Layout;
+}
+
+bool VulkanStateTracker::Transition(State &state,
+	VkImageLayout layout,
+	VkAccessFlags access,
+	VkPipelineStageFlags stages,
+	VkAccessFlags *srcAccess,
+	StagePair *barrierStages)
+{
+	bool layoutChange = state.Layout != layout;
+	bool write = (access & WriteAccessMask) != 0;
+	VkPipelineStageFlags srcStages = 0;
+
+	if (layoutChange || write)
+	{
+		srcStages = state.WriteStages | state.ReadStages;
+		*srcAccess = state.WriteAccess;
+
+		state.WriteStages = stages;
+		state.WriteAccess = write ? access : 0;
+		state.ReadStages = write ? 0 : stages;
+		state.ReadAccess = write ? 0 : access;
+		state.Layout = layout;
+
+		if (srcStages == 0 && !layoutChange)
+		{
+			mStats.SkippedTransitions++;
+			return false;
+		}
+	}
+	else
+	{
+		if (state.WriteStages == 0 ||
+			((stages & ~state.ReadStages) == 0 && (access & ~state.ReadAccess) == 0))
+		{
+			state.ReadStages |= stages;
+			state.ReadAccess |= access;
+			mStats.SkippedTransitions++;
+			return false;
+		}
+
+		srcStages = state.WriteStages;
+		*srcAccess = state.WriteAccess;
+
+		state.ReadStages |= stages;
+		state.ReadAccess |= access;
+	}
+
+	barrierStages->first = srcStages == 0 ? VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT : srcStages;
+	barrierStages->second = stages == 0 ? VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT : stages;
+
+	mSrcStages |= barrierStages->first;
+	mDstStages |= barrierStages->second;
+
+	return true;
+}
+
+void VulkanStateTracker::Flush2()
+{
+	mBufferBarriers2.clear();
+	mImageBarriers2.clear();
+
+	for (size_t index = 0; index < mBufferBarriers.size(); index++)
+	{
+		const VkBufferMemoryBarrier &barrier = mBufferBarriers[index];
+
+		mBufferBarriers2.push_back({
+			VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2_KHR,
+			nullptr,
+			mBufferStages[index].first,
+			barrier.srcAccessMask,
+			mBufferStages[index].second,
+			barrier.dstAccessMask,
+			barrier.srcQueueFamilyIndex,
+			barrier.dstQueueFamilyIndex,
+			barrier.buffer,
+			barrier.offset,
+			barrier.size
+		});
+	}
+
+	for (size_t index = 0; index < mImageBarriers.size(); index++)
+	{
+		const VkImageMemoryBarrier &barrier = mImageBarriers[index];
+
+		mImageBarriers2.push_back({
+			VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR,
+			nullptr,
+			mImageStages[index].first,
+			barrier.srcAccessMask,
+			mImageStages[index].second,
+			barrier.dstAccessMask,
+			barrier.oldLayout,
+			barrier.newLayout,
+			barrier.srcQueueFamilyIndex,
+			barrier.dstQueueFamilyIndex,
+			barrier.image,
+			barrier.subresourceRange
+		});
+	}
+
+	VkDependencyInfoKHR dependencyInfo =
+	{
+		VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR,
+		nullptr,
+		0,
+		0,
+		nullptr,
+		static_cast<uint32_t>(mBufferBarriers2.size()),
+		mBufferBarriers2.size() > 0 ? &mBufferBarriers2[0] : nullptr,
+		static_cast<uint32_t>(mImageBarriers2.size()),
+		mImageBarriers2.size() > 0 ? &mImageBarriers2[0] : nullptr
+	};
+
+	mCmdPipelineBarrier2(mCommandBuffer, &dependencyInfo);
+}
+
+void VulkanStateTracker::MergeMipLevels(size_t firstBarrier)
+{
+	size_t last = firstBarrier;
+
+	for (size_t index = firstBarrier + 1; index < mImageBarriers.size(); index++)
+	{
+		VkImageMemoryBarrier &merged = mImageBarriers[last];
+		const VkImageMemoryBarrier &barrier = mImageBarriers[index];
+
+		if (merged.srcAccessMask == barrier.srcAccessMask &&
+			merged.oldLayout == barrier.oldLayout &&
+			merged.subresourceRange.baseArrayLayer == barrier.subresourceRange.baseArrayLayer &&
+			merged.subresourceRange.layerCount == barrier.subresourceRange.layerCount &&
+			merged.subresourceRange.baseMipLevel + merged.subresourceRange.levelCount == 
+				barrier.subresourceRange.baseMipLevel)
+		{
+			merged.subresourceRange.levelCount++;
+			mImageStages[last].first |= mImageStages[index].first;
+		}
+		else
+		{
+			mImageBarriers[++last] = barrier;
+			mImageStages[last] = mImageStages[index];
+		}
+	}
+
+	if (mImageBarriers.size() > firstBarrier)
+	{
+		mImageBarriers.resize(last + 1);
+		mImageStages.resize(last + 1);
+	}
+}
+
+bool VulkanStateTracker::HasPendingBarrier(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize end) const
+{
+	for (const auto& barrier : mBufferBarriers)
+	{
+		VkDeviceSize barrierEnd = barrier.size == VK_WHOLE_SIZE ? 
+			UINT64_MAX : barrier.offset + barrier.size;
+
+		if (barrier.buffer == buffer && barrier.offset < end && offset < barrierEnd)
+			return true;
+	}
+
+	return false;
+}
+
+bool VulkanStateTracker::HasPendingBarrier(VkImage image, 
+	uint32_t baseMipLevel, uint32_t levelCount,
+	uint32_t baseArrayLayer, uint32_t layerCount) const
+{
+	for (const auto& barrier : mImageBarriers)
+	{
+		const VkImageSubresourceRange &range = barrier.subresourceRange;
+
+		if (barrier.image == image &&
+			range.baseMipLevel < baseMipLevel + levelCount &&
+			baseMipLevel < range.baseMipLevel + range.levelCount &&
+			range.baseArrayLayer < baseArrayLayer + layerCount &&
+			baseArrayLayer < range.baseArrayLayer + range.layerCount)
+			return true;
+	}
+
+	return false;
+}
+
+void VulkanStateTracker::SplitBufferRange(std::map<VkDeviceSize, BufferRange> &ranges, VkDeviceSize offset)
+{
+	auto it = ranges.upper_bound(offset);
+
+	if (it == ranges.begin())
+		return;
+
+	--it;
+
+	if (it->first == offset || it->first + it->second.Size <= offset)
+		return;
+
+	BufferRange tail = { it->first + it->second.Size - offset, it->second.RangeState };
+
+	it->second.Size = offset - it->first;
+	ranges.insert({ offset, tail });
+}
\ No newline at end of file
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <map>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+struct VulkanStateTrackerStats
+{
+	uint32_t BarrierCalls;
+	uint32_t BufferBarriers;
+	uint32_t ImageBarriers;
+	uint32_t SkippedTransitions;
+};
+
+class VulkanStateTracker
+{
+private:
+
+	struct State
+	{
+		VkPipelineStageFlags WriteStages;
+		VkAccessFlags WriteAccess;
+		VkPipelineStageFlags ReadStages;
+		VkAccessFlags ReadAccess;
+		VkImageLayout Layout;
+	};
+
+	struct BufferRange
+	{
+		VkDeviceSize Size;
+		State RangeState;
+	};
+
+	struct ImageState
+	{
+		VkImageAspectFlags AspectFlags;
+		uint32_t MipLevels;
+		uint32_t ArrayLayers;
+		std::vector<State> Subresources;
+	};
+
+	typedef std::pair<VkPipelineStageFlags, VkPipelineStageFlags> StagePair;
+
+	VkCommandBuffer									mCommandBuffer;
+	PFN_vkCmdPipelineBarrier2KHR					mCmdPipelineBarrier2;
+	std::map<VkBuffer, std::map<VkDeviceSize, BufferRange>>	mBuffers;
+	std::map<VkImage, ImageState>					mImages;
+	std::vector<VkBufferMemoryBarrier>				mBufferBarriers;
+	std::vector<VkImageMemoryBarrier>				mImageBarriers;
+	std::vector<StagePair>							mBufferStages;
+	std::vector<StagePair>							mImageStages;
+	std::vector<VkBufferMemoryBarrier2KHR>			mBufferBarriers2;
+	std::vector<VkImageMemoryBarrier2KHR>			mImageBarriers2;
+	VkPipelineStageFlags							mSrcStages;
+	VkPipelineStageFlags							mDstStages;
+	VulkanStateTrackerStats							mStats;
+
+public:
+
+	VulkanStateTracker();
+	~VulkanStateTracker();
+
+	void SetSynchronization2(PFN_vkCmdPipelineBarrier2KHR cmdPipelineBarrier2);
+
+	void Begin(VkCommandBuffer commandBuffer);
+	void Reset();
+
+	void TrackImage(VkImage image,
+		VkImageAspectFlags aspectFlags,
+		uint32_t mipLevels,
+		uint32_t arrayLayers,
+		VkImageLayout layout,
+		VkAccessFlags access,
+		VkPipelineStageFlags stages);
+
+	void UseBuffer(VkBuffer buffer,
+		VkDeviceSize offset,
+		VkDeviceSize size,
+		VkAccessFlags access,
+		VkPipelineStageFlags stages);
+
+	void UseImage(VkImage image,
+		const VkImageSubresourceRange &range,
+		VkImageLayout layout,
+		VkAccessFlags access,
+		VkPipelineStageFlags stages);
+
+	void Flush();
+
+	VkImageLayout GetImageLayout(VkImage image, uint32_t mipLevel, uint32_t arrayLayer) const;
+
+	const VulkanStateTrackerStats& GetStats() const
+	{
+		return mStats;
+	}
+
+private:
+
+	bool Transition(State &state,
+		VkImageLayout layout,
+		VkAccessFlags access,
+		VkPipelineStageFlags stages,
+		VkAccessFlags *srcAccess,
+		StagePair *barrierStages);
+
+	void MergeMipLevels(size_t firstBarrier);
+
+	bool HasPendingBarrier(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize end) const;
+	bool HasPendingBarrier(VkImage image, 
+		uint32_t baseMipLevel, uint32_t levelCount,
+		uint32_t baseArrayLayer, uint32_t layerCount) const;
+
+	void Flush2();
+	void SplitBufferRange(std::map<VkDeviceSize, BufferRange> &ranges, VkDeviceSize offset);
+};
\ No newline at end of file
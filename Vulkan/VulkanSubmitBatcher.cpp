@@ -0,0 +1,210 @@
+#include "VulkanSubmitBatcher.h"
+#include "Logger.h"
+
+VulkanSubmitBatcher::VulkanSubmitBatcher()
+	: mQueue(nullptr),
+	mQueueSubmit2(nullptr),
+	mQueueSubmitCount(0)
+{
+}
+
+VulkanSubmitBatcher::~VulkanSubmitBatcher()
+{
+	Destroy();
+}
+
+void VulkanSubmitBatcher::Initialize(VkQueue queue, PFN_vkQueueSubmit2KHR queueSubmit2)
+{
+	mQueue = queue;
+	mQueueSubmit2 = queueSubmit2;
+	mSubmits.clear();
+	mQueueSubmitCount = 0;
+}
+
+void VulkanSubmitBatcher::Destroy()
+{
+	mQueue = nullptr;
+	mQueueSubmit2 = nullptr;
+	mSubmits.clear();
+	mSubmitInfos.clear();
+	mTimelineInfos.clear();
+	mSubmitInfos2.clear();
+	mSemaphoreInfos.clear();
+	mCommandBufferInfos.clear();
+}
+
+void VulkanSubmitBatcher::Add(const std::vector<VkCommandBuffer> &buffers,
+	const std::vector<VkSemaphore> &waitSemaphores,
+	const std::vector<VkPipelineStageFlags> &waitStages,
+	const std::vector<VkSemaphore> &signalSemaphores,
+	VkFence fence,
+	const std::vector<uint64_t> &waitValues,
+	const std::vector<uint64_t> &signalValues)
+{
+	mSubmits.push_back({
+		buffers,
+		waitSemaphores,
+		waitStages,
+		signalSemaphores,
+		waitValues,
+		signalValues,
+		fence
+	});
+}
+
+VkResult VulkanSubmitBatcher::Flush()
+{
+	if (mSubmits.empty())
+		return VK_SUCCESS;
+
+	uint32_t first = 0;
+
+	for (uint32_t index = 0; index < static_cast<uint32_t>(mSubmits.size()); index++)
+	{
+		VkFence fence = mSubmits[index].Fence;
+
+		if (fence == nullptr && index + 1 < mSubmits.size())
+			continue;
+
+		VkResult result = mQueueSubmit2 ? 
+			SubmitRange2(first, index, fence) : 
+			SubmitRange(first, index, fence);
+
+		mQueueSubmitCount++;
+
+		if (result != VK_SUCCESS)
+		{
+			LOG_ERROR("Unable to submit batched Command buffers");
+			mSubmits.erase(mSubmits.begin(), mSubmits.begin() + index + 1);
+			return result;
+		}
+
+		first = index + 1;
+	}
+
+	mSubmits.clear();
+	return VK_SUCCESS;
+}
+
+VkResult VulkanSubmitBatcher::SubmitRange(uint32_t first, uint32_t last, VkFence fence)
+{
+	mSubmitInfos.clear();
+	mTimelineInfos.clear();
+
+	for (uint32_t submit = first; submit <= last; submit++)
+	{
+		const Submit &entry = mSubmits[submit];
+
+		mTimelineInfos.push_back({
+			VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR,
+			nullptr,
+			static_cast<uint32_t>(entry.WaitValues.size()),
+			entry.WaitValues.size() > 0 ? &entry.WaitValues[0] : nullptr,
+			static_cast<uint32_t>(entry.SignalValues.size()),
+			entry.SignalValues.size() > 0 ? &entry.SignalValues[0] : nullptr
+		});
+	}
+
+	for (uint32_t submit = first; submit <= last; submit++)
+	{
+		const Submit &entry = mSubmits[submit];
+		bool timeline = entry.WaitValues.size() > 0 || entry.SignalValues.size() > 0;
+
+		mSubmitInfos.push_back({
+			VK_STRUCTURE_TYPE_SUBMIT_INFO,
+			timeline ? &mTimelineInfos[submit - first] : nullptr,
+			static_cast<uint32_t>(entry.WaitSemaphores.size()),
+			entry.WaitSemaphores.size() > 0 ? &entry.WaitSemaphores[0] : nullptr,
+			entry.WaitStages.size() > 0 ? &entry.WaitStages[0] : nullptr,
+			static_cast<uint32_t>(entry.CommandBuffers.size()),
+			entry.CommandBuffers.size() > 0 ? &entry.CommandBuffers[0] : nullptr,
+			static_cast<uint32_t>(entry.SignalSemaphores.size()),
+			entry.SignalSemaphores.size() > 0 ? &entry.SignalSemaphores[0] : nullptr
+		});
+	}
+
+	return vkQueueSubmit(
+		mQueue,
+		static_cast<uint32_t>(mSubmitInfos.size()),
+		&mSubmitInfos[0],
+		fence
+	);
+}
+
+VkResult VulkanSubmitBatcher::SubmitRange2(uint32_t first, uint32_t last, VkFence fence)
+{
+	mSubmitInfos2.clear();
+	mSemaphoreInfos.clear();
+	mCommandBufferInfos.clear();
+
+	for (uint32_t submit = first; submit <= last; submit++)
+	{
+		const Submit &entry = mSubmits[submit];
+
+		for (size_t wait = 0; wait < entry.WaitSemaphores.size(); wait++)
+		{
+			mSemaphoreInfos.push_back({
+				VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO_KHR,
+				nullptr,
+				entry.WaitSemaphores[wait],
+				wait < entry.WaitValues.size() ? entry.WaitValues[wait] : 0,
+				entry.WaitStages[wait],
+				0
+			});
+		}
+
+		for (size_t signal = 0; signal < entry.SignalSemaphores.size(); signal++)
+		{
+			mSemaphoreInfos.push_back({
+				VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO_KHR,
+				nullptr,
+				entry.SignalSemaphores[signal],
+				signal < entry.SignalValues.size() ? entry.SignalValues[signal] : 0,
+				VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR,
+				0
+			});
+		}
+
+		for (auto buffer : entry.CommandBuffers)
+		{
+			mCommandBufferInfos.push_back({
+				VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO_KHR,
+				nullptr,
+				buffer,
+				0
+			});
+		}
+	}
+
+	size_t semaphoreInfo = 0;
+	size_t commandBufferInfo = 0;
+
+	for (uint32_t submit = first; submit <= last; submit++)
+	{
+		const Submit &entry = mSubmits[submit];
+		size_t waitInfo = semaphoreInfo;
+		size_t signalInfo = semaphoreInfo + entry.WaitSemaphores.size();
+
+		mSubmitInfos2.push_back({
+			VK_STRUCTURE_TYPE_SUBMIT_INFO_2_KHR,
+			nullptr,
+			0,
+			static_cast<uint32_t>(entry.WaitSemaphores.size()),
+			entry.WaitSemaphores.size() > 0 ? &mSemaphoreInfos[waitInfo] : nullptr,
+			static_cast<uint32_t>(entry.CommandBuffers.size()),
+			entry.CommandBuffers.size() > 0 ? &mCommandBufferInfos[commandBufferInfo] : nullptr,
+			static_cast<uint32_t>(entry.SignalSemaphores.size()),
+			entry.SignalSemaphores.size() > 0 ? &mSemaphoreInfos[signalInfo] : nullptr
+		});
+
+		semaphoreInfo = signalInfo + entry.SignalSemaphores.size();
+		commandBufferInfo += entry.CommandBuffers.size();
+	}
+
+	return mQueueSubmit2(
+		mQueue,
+		static_cast<uint32_t>(mSubmitInfos2.size()),
+		&mSubmitInfos2[0],
+		fence
+	);
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+#include <vulkan/vulkan.h>
+
+class VulkanSubmitBatcher
+{
+private:
+
+	struct Submit
+	{
+		std::vector<VkCommandBuffer> CommandBuffers;
+		std::vector<VkSemaphore> WaitSemaphores;
+		std::vector<VkPipelineStageFlags> WaitStages;
+		std::vector<VkSemaphore> SignalSemaphores;
+		std::vector<uint64_t> WaitValues;
+		std::vector<uint64_t> SignalValues;
+		VkFence Fence;
+	};
+
+	VkQueue							mQueue;
+	std::vector<Submit>				mSubmits;
+	std::vector<VkSubmitInfo>		mSubmitInfos;
+	std::vector<VkTimelineSemaphoreSubmitInfoKHR>	mTimelineInfos;
+	std::vector<VkSubmitInfo2KHR>	mSubmitInfos2;
+	std::vector<VkSemaphoreSubmitInfoKHR>	mSemaphoreInfos;
+	std::vector<VkCommandBufferSubmitInfoKHR>	mCommandBufferInfos;
+	PFN_vkQueueSubmit2KHR			mQueueSubmit2;
+	uint64_t						mQueueSubmitCount;
+
+public:
+
+	VulkanSubmitBatcher();
+	~VulkanSubmitBatcher();
+
+	VkQueue GetQueue() const
+	{
+		return mQueue;
+	}
+
+	bool IsEmpty() const
+	{
+		return mSubmits.empty();
+	}
+
+	uint64_t GetQueueSubmitCount() const
+	{
+		return mQueueSubmitCount;
+	}
+
+	void Initialize(VkQueue queue, PFN_vkQueueSubmit2KHR queueSubmit2 = nullptr);
+	void Destroy();
+
+	void Add(const std::vector<VkCommandBuffer> &buffers,
+		const std::vector<VkSemaphore> &waitSemaphores,
+		const std::vector<VkPipelineStageFlags> &waitStages,
+		const std::vector<VkSemaphore> &signalSemaphores,
+		VkFence fence,
+		const std::vector<uint64_t> &waitValues = {},
+		const std::vector<uint64_t> &signalValues = {});
+
+	VkResult Flush();
+
+private:
+
+	VkResult SubmitRange(uint32_t first, uint32_t last, VkFence fence);
+	VkResult SubmitRange2(uint32_t first, uint32_t last, VkFence fence);
+};
\ No newline at end of file
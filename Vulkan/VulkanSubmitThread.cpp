@@ -0,0 +1,327 @@
+#include "VulkanSubmitThread.h"
+#include "Logger.h"
+
+VulkanSubmitThread::VulkanSubmitThread()
+	: mDevice(nullptr),
+	mHead(0),
+	mTail(0),
+	mCompletedToken(0),
+	mSleeping(false),
+	mPresentResult(VK_SUCCESS),
+	mSubmitResult(VK_SUCCESS),
+	mAcquireResult(VK_SUCCESS),
+	mAcquireImageIndex(0),
+	mMaxQueueDepth(0),
+	mNextToken(0),
+	mExit(false),
+	mPacketCount(0),
+	mTotalLatency(0.0),
+	mMaxLatency(0.0)
+{
+}
+
+VulkanSubmitThread::~VulkanSubmitThread()
+{
+	Destroy();
+}
+
+bool VulkanSubmitThread::Initialize(VkDevice device,
+	const std::vector<VkQueue> &queues,
+	PFN_vkQueueSubmit2KHR queueSubmit2,
+	uint32_t capacity)
+{
+	if (device == nullptr || queues.empty() || capacity == 0)
+	{
+		LOG_ERROR("Invalid submit thread parameters");
+		return false;
+	}
+
+	Destroy();
+
+	mDevice = device;
+	mQueues = queues;
+	mBatchers.resize(queues.size());
+
+	for (uint32_t index = 0; index < static_cast<uint32_t>(queues.size()); index++)
+		mBatchers[index].Initialize(queues[index], queueSubmit2);
+
+	mPackets.resize(capacity);
+	mHead = 0;
+	mTail = 0;
+	mCompletedToken = 0;
+	mNextToken = 0;
+	mPresentResult = VK_SUCCESS;
+	mSubmitResult = VK_SUCCESS;
+	mAcquireResult = VK_SUCCESS;
+	mAcquireImageIndex = 0;
+	mMaxQueueDepth = 0;
+	mPacketCount = 0;
+	mTotalLatency = 0.0;
+	mMaxLatency = 0.0;
+	mExit = false;
+
+	mThread = std::thread(&VulkanSubmitThread::SubmitMain, this);
+
+	return true;
+}
+
+void VulkanSubmitThread::Destroy()
+{
+	if (mThread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mExit = true;
+		}
+
+		mPacketCondition.notify_one();
+		mThread.join();
+	}
+
+	mBatchers.clear();
+	mPackets.clear();
+	mQueues.clear();
+	mDevice = nullptr;
+}
+
+uint64_t VulkanSubmitThread::Submit(uint32_t queueIndex,
+	const std::vector<VkCommandBuffer> &buffers,
+	const std::vector<VkSemaphore> &waitSemaphores,
+	const std::vector<VkPipelineStageFlags> &waitStages,
+	const std::vector<VkSemaphore> &signalSemaphores,
+	VkFence fence,
+	const std::vector<uint64_t> &waitValues,
+	const std::vector<uint64_t> &signalValues)
+{
+	Packet &packet = BeginPacket(PacketType::Submit, queueIndex);
+
+	packet.CommandBuffers = buffers;
+	packet.WaitSemaphores = waitSemaphores;
+	packet.WaitStages = waitStages;
+	packet.SignalSemaphores = signalSemaphores;
+	packet.WaitValues = waitValues;
+	packet.SignalValues = signalValues;
+	packet.Fence = fence;
+
+	return EndPacket(packet);
+}
+
+uint64_t VulkanSubmitThread::Flush(uint32_t queueIndex)
+{
+	return EndPacket(BeginPacket(PacketType::Flush, queueIndex));
+}
+
+uint64_t VulkanSubmitThread::Present(uint32_t queueIndex,
+	VkSwapchainKHR swapChain,
+	uint32_t imageIndex,
+	const std::vector<VkSemaphore> &waitSemaphores)
+{
+	Packet &packet = BeginPacket(PacketType::Present, queueIndex);
+
+	packet.SwapChain = swapChain;
+	packet.ImageIndex = imageIndex;
+	packet.WaitSemaphores = waitSemaphores;
+
+	return EndPacket(packet);
+}
+
+uint64_t VulkanSubmitThread::Acquire(VkSwapchainKHR swapChain, VkSemaphore semaphore)
+{
+	Packet &packet = BeginPacket(PacketType::Acquire, 0);
+
+	packet.SwapChain = swapChain;
+	packet.SignalSemaphores.push_back(semaphore);
+
+	return EndPacket(packet);
+}
+
+void VulkanSubmitThread::Wait(uint64_t token)
+{
+	if (IsComplete(token))
+		return;
+
+	std::unique_lock<std::mutex> lock(mMutex);
+	mCompleteCondition.wait(lock, [this, token] { return IsComplete(token); });
+}
+
+void VulkanSubmitThread::GetStats(VulkanSubmitThreadStats *stats) const
+{
+	std::lock_guard<std::mutex> lock(mStatsMutex);
+
+	stats->PacketCount = mPacketCount;
+	stats->QueueDepth = static_cast<uint32_t>(mTail.load() - mHead.load());
+	stats->MaxQueueDepth = mMaxQueueDepth.load();
+	stats->AverageLatency = mPacketCount > 0 ? mTotalLatency / mPacketCount : 0.0;
+	stats->MaxLatency = mMaxLatency;
+}
+
+VulkanSubmitThread::Packet& VulkanSubmitThread::BeginPacket(PacketType type, uint32_t queueIndex)
+{
+	uint64_t tail = mTail.load(std::memory_order_relaxed);
+
+	while (tail - mHead.load(std::memory_order_acquire) >= mPackets.size())
+		std::this_thread::yield();
+
+	Packet &packet = mPackets[tail % mPackets.size()];
+
+	packet.Type = type;
+	packet.QueueIndex = queueIndex;
+	packet.CommandBuffers.clear();
+	packet.WaitSemaphores.clear();
+	packet.WaitStages.clear();
+	packet.SignalSemaphores.clear();
+	packet.WaitValues.clear();
+	packet.SignalValues.clear();
+	packet.Fence = nullptr;
+	packet.SwapChain = VK_NULL_HANDLE;
+	packet.ImageIndex = 0;
+
+	return packet;
+}
+
+uint64_t VulkanSubmitThread::EndPacket(Packet &packet)
+{
+	packet.Token = ++mNextToken;
+	packet.EnqueueTime = Clock::now();
+
+	uint64_t tail = mTail.load(std::memory_order_relaxed) + 1;
+	uint32_t depth = static_cast<uint32_t>(tail - mHead.load());
+
+	if (depth > mMaxQueueDepth.load(std::memory_order_relaxed))
+		mMaxQueueDepth.store(depth, std::memory_order_relaxed);
+
+	mTail.store(tail);
+
+	if (mSleeping.load())
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mPacketCondition.notify_one();
+	}
+
+	return packet.Token;
+}
+
+void VulkanSubmitThread::SubmitMain()
+{
+	while (true)
+	{
+		uint64_t head = mHead.load(std::memory_order_relaxed);
+
+		if (head == mTail.load())
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+
+			mSleeping = true;
+
+			while (head == mTail.load() && !mExit)
+				mPacketCondition.wait(lock);
+
+			mSleeping = false;
+
+			if (head == mTail.load())
+				break;
+
+			continue;
+		}
+
+		Packet &packet = mPackets[head % mPackets.size()];
+
+		Process(packet);
+
+		double latency = std::chrono::duration<double, std::milli>(
+			Clock::now() - packet.EnqueueTime).count();
+
+		{
+			std::lock_guard<std::mutex> lock(mStatsMutex);
+
+			mPacketCount++;
+			mTotalLatency += latency;
+
+			if (latency > mMaxLatency)
+				mMaxLatency = latency;
+		}
+
+		uint64_t token = packet.Token;
+		mHead.store(head + 1, std::memory_order_release);
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mCompletedToken = token;
+		}
+
+		mCompleteCondition.notify_all();
+	}
+
+	for (auto& batcher : mBatchers)
+		FlushBatcher(batcher);
+}
+
+void VulkanSubmitThread::Process(Packet &packet)
+{
+	if (packet.Type == PacketType::Submit)
+	{
+		mBatchers[packet.QueueIndex].Add(
+			packet.CommandBuffers,
+			packet.WaitSemaphores,
+			packet.WaitStages,
+			packet.SignalSemaphores,
+			packet.Fence,
+			packet.WaitValues,
+			packet.SignalValues
+		);
+	}
+	else if (packet.Type == PacketType::Flush)
+	{
+		FlushBatcher(mBatchers[packet.QueueIndex]);
+	}
+	else if (packet.Type == PacketType::Acquire)
+	{
+		uint32_t imageIndex = 0;
+
+		VkResult result = vkAcquireNextImageKHR(
+			mDevice,
+			packet.SwapChain,
+			UINT64_MAX,
+			packet.SignalSemaphores[0],
+			VK_NULL_HANDLE,
+			&imageIndex
+		);
+
+		mAcquireImageIndex = imageIndex;
+		mAcquireResult = result;
+	}
+	else
+	{
+		VkPresentInfoKHR presentInfo =
+		{
+			VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
+			nullptr,
+			static_cast<uint32_t>(packet.WaitSemaphores.size()),
+			packet.WaitSemaphores.size() > 0 ? &packet.WaitSemaphores[0] : nullptr,
+			1,
+			&packet.SwapChain,
+			&packet.ImageIndex,
+			nullptr
+		};
+
+		VkResult result = vkQueuePresentKHR(
+			mQueues[packet.QueueIndex],
+			&presentInfo
+		);
+
+		if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR && 
+			result != VK_ERROR_OUT_OF_DATE_KHR)
+			LOG_ERROR("Unable to present Swapchain image");
+
+		mPresentResult = result;
+	}
+}
+
+void VulkanSubmitThread::FlushBatcher(VulkanSubmitBatcher &batcher)
+{
+	VkResult result = batcher.Flush();
+
+	// the first failure sticks, its fences will never signal
+	if (result != VK_SUCCESS && mSubmitResult.load() == VK_SUCCESS)
+		mSubmitResult = result;
+}
\ No newline at end of file
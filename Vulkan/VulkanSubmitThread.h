@@ -0,0 +1,145 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "VulkanSubmitBatcher.h"
+
+struct VulkanSubmitThreadStats
+{
+	uint64_t PacketCount;
+	uint32_t QueueDepth;
+	uint32_t MaxQueueDepth;
+	double AverageLatency;
+	double MaxLatency;
+};
+
+class VulkanSubmitThread
+{
+private:
+
+	typedef std::chrono::high_resolution_clock Clock;
+
+	enum class PacketType
+	{
+		Submit,
+		Flush,
+		Present,
+		Acquire
+	};
+
+	struct Packet
+	{
+		PacketType Type;
+		uint32_t QueueIndex;
+		std::vector<VkCommandBuffer> CommandBuffers;
+		std::vector<VkSemaphore> WaitSemaphores;
+		std::vector<VkPipelineStageFlags> WaitStages;
+		std::vector<VkSemaphore> SignalSemaphores;
+		std::vector<uint64_t> WaitValues;
+		std::vector<uint64_t> SignalValues;
+		VkFence Fence;
+		VkSwapchainKHR SwapChain;
+		uint32_t ImageIndex;
+		uint64_t Token;
+		Clock::time_point EnqueueTime;
+	};
+
+	VkDevice							mDevice;
+	std::vector<VkQueue>				mQueues;
+	std::vector<VulkanSubmitBatcher>	mBatchers;
+	std::vector<Packet>					mPackets;
+	std::atomic<uint64_t>				mHead;
+	std::atomic<uint64_t>				mTail;
+	std::atomic<uint64_t>				mCompletedToken;
+	std::atomic<bool>					mSleeping;
+	std::atomic<VkResult>				mPresentResult;
+	std::atomic<VkResult>				mSubmitResult;
+	std::atomic<VkResult>				mAcquireResult;
+	std::atomic<uint32_t>				mAcquireImageIndex;
+	std::atomic<uint32_t>				mMaxQueueDepth;
+	uint64_t							mNextToken;
+	bool								mExit;
+	std::thread							mThread;
+	std::mutex							mMutex;
+	std::condition_variable				mPacketCondition;
+	std::condition_variable				mCompleteCondition;
+	mutable std::mutex					mStatsMutex;
+	uint64_t							mPacketCount;
+	double								mTotalLatency;
+	double								mMaxLatency;
+
+public:
+
+	VulkanSubmitThread();
+	~VulkanSubmitThread();
+
+	bool IsRunning() const
+	{
+		return mThread.joinable();
+	}
+
+	bool Initialize(VkDevice device,
+		const std::vector<VkQueue> &queues,
+		PFN_vkQueueSubmit2KHR queueSubmit2,
+		uint32_t capacity);
+
+	void Destroy();
+
+	uint64_t Submit(uint32_t queueIndex,
+		const std::vector<VkCommandBuffer> &buffers,
+		const std::vector<VkSemaphore> &waitSemaphores,
+		const std::vector<VkPipelineStageFlags> &waitStages,
+		const std::vector<VkSemaphore> &signalSemaphores,
+		VkFence fence,
+		const std::vector<uint64_t> &waitValues = {},
+		const std::vector<uint64_t> &signalValues = {});
+
+	uint64_t Flush(uint32_t queueIndex);
+
+	uint64_t Present(uint32_t queueIndex,
+		VkSwapchainKHR swapChain,
+		uint32_t imageIndex,
+		const std::vector<VkSemaphore> &waitSemaphores);
+
+	uint64_t Acquire(VkSwapchainKHR swapChain, VkSemaphore semaphore);
+
+	bool IsComplete(uint64_t token) const
+	{
+		return mCompletedToken.load() >= token;
+	}
+
+	void Wait(uint64_t token);
+
+	VkResult TakePresentResult()
+	{
+		return mPresentResult.exchange(VK_SUCCESS);
+	}
+
+	VkResult GetAcquireResult(uint32_t *imageIndex) const
+	{
+		*imageIndex = mAcquireImageIndex.load();
+		return mAcquireResult.load();
+	}
+
+	VkResult GetSubmitResult() const
+	{
+		return mSubmitResult.load();
+	}
+
+	void GetStats(VulkanSubmitThreadStats *stats) const;
+
+private:
+
+	Packet& BeginPacket(PacketType type, uint32_t queueIndex);
+	uint64_t EndPacket(Packet &packet);
+
+	void SubmitMain();
+	void Process(Packet &packet);
+	void FlushBatcher(VulkanSubmitBatcher &batcher);
+};
\ No newline at end of file
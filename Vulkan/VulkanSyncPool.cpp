@@ -0,0 +1,183 @@
+#include "VulkanSyncPool.h"
+#include "Logger.h"
+
+VulkanSyncPool::VulkanSyncPool()
+	: mDevice(nullptr),
+	mFenceHighWater(0),
+	mSemaphoreHighWater(0)
+{
+}
+
+VulkanSyncPool::~VulkanSyncPool()
+{
+	Destroy();
+}
+
+bool VulkanSyncPool::Initialize(VkDevice device)
+{
+	if (device == nullptr)
+	{
+		LOG_ERROR("Invalid sync pool device");
+		return false;
+	}
+
+	Destroy();
+	mDevice = device;
+
+	return true;
+}
+
+void VulkanSyncPool::Destroy()
+{
+	for (auto fence : mFences)
+		vkDestroyFence(mDevice, fence, nullptr);
+
+	for (auto semaphore : mSemaphores)
+		vkDestroySemaphore(mDevice, semaphore, nullptr);
+
+	mFences.clear();
+	mFreeFences.clear();
+	mReleasedFences.clear();
+	mSemaphores.clear();
+	mFreeSemaphores.clear();
+	mReleasedSemaphores.clear();
+
+	mFenceHighWater = 0;
+	mSemaphoreHighWater = 0;
+	mDevice = nullptr;
+}
+
+bool VulkanSyncPool::AcquireFence(VkFence *fence)
+{
+	if (mFreeFences.empty() && !ResetReleasedFences())
+		return false;
+
+	if (!mFreeFences.empty())
+	{
+		*fence = mFreeFences.back();
+		mFreeFences.pop_back();
+	}
+	else
+	{
+		VkFenceCreateInfo createInfo =
+		{
+			VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+			nullptr,
+			0
+		};
+
+		VkResult result = vkCreateFence(
+			mDevice,
+			&createInfo,
+			nullptr,
+			fence
+		);
+
+		if (result != VK_SUCCESS)
+		{
+			LOG_ERROR("Unable to create pooled Fence");
+			return false;
+		}
+
+		mFences.push_back(*fence);
+	}
+
+	uint32_t inUse = static_cast<uint32_t>(mFences.size() - mFreeFences.size() - mReleasedFences.size());
+
+	if (inUse > mFenceHighWater)
+		mFenceHighWater = inUse;
+
+	return true;
+}
+
+void VulkanSyncPool::ReleaseFence(VkFence fence)
+{
+	if (fence)
+		mReleasedFences.push_back(fence);
+}
+
+bool VulkanSyncPool::ResetReleasedFences()
+{
+	if (mReleasedFences.empty())
+		return true;
+
+	VkResult result = vkResetFences(
+		mDevice,
+		static_cast<uint32_t>(mReleasedFences.size()),
+		&mReleasedFences[0]
+	);
+
+	if (result != VK_SUCCESS)
+	{
+		LOG_ERROR("Unable to reset pooled fences");
+		return false;
+	}
+
+	mFreeFences.insert(mFreeFences.end(), mReleasedFences.begin(), mReleasedFences.end());
+	mReleasedFences.clear();
+
+	return true;
+}
+
+bool VulkanSyncPool::AcquireSemaphore(VkSemaphore *semaphore)
+{
+	if (!mFreeSemaphores.empty())
+	{
+		*semaphore = mFreeSemaphores.back();
+		mFreeSemaphores.pop_back();
+	}
+	else
+	{
+		VkSemaphoreCreateInfo createInfo =
+		{
+			VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+			nullptr,
+			0
+		};
+
+		VkResult result = vkCreateSemaphore(
+			mDevice,
+			&createInfo,
+			nullptr,
+			semaphore
+		);
+
+		if (result != VK_SUCCESS)
+		{
+			LOG_ERROR("Unable to create pooled Semaphore");
+			return false;
+		}
+
+		mSemaphores.push_back(*semaphore);
+	}
+
+	uint32_t inUse = static_cast<uint32_t>(mSemaphores.size() - mFreeSemaphores.size());
+
+	if (inUse > mSemaphoreHighWater)
+		mSemaphoreHighWater = inUse;
+
+	return true;
+}
+
+void VulkanSyncPool::ReleaseSemaphore(VkSemaphore semaphore, uint64_t value)
+{
+	if (semaphore)
+		mReleasedSemaphores.push_back({ value, semaphore });
+}
+
+void VulkanSyncPool::RetireSemaphores(uint64_t completedValue)
+{
+	while (!mReleasedSemaphores.empty() && mReleasedSemaphores.front().first <= completedValue)
+	{
+		mFreeSemaphores.push_back(mReleasedSemaphores.front().second);
+		mReleasedSemaphores.pop_front();
+	}
+}
+
+void VulkanSyncPool::GetStats(VulkanSyncPoolStats *stats) const
+{
+	stats->FenceCount = static_cast<uint32_t>(mFences.size());
+	stats->FenceHighWater = mFenceHighWater;
+	stats->SemaphoreCount = static_cast<uint32_t>(mSemaphores.size());
+	stats->SemaphoreHighWater = mSemaphoreHighWater;
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+struct VulkanSyncPoolStats
+{
+	uint32_t FenceCount;
+	uint32_t FenceHighWater;
+	uint32_t SemaphoreCount;
+	uint32_t SemaphoreHighWater;
+};
+
+class VulkanSyncPool
+{
+private:
+
+	VkDevice								mDevice;
+	std::vector<VkFence>					mFences;
+	std::vector<VkFence>					mFreeFences;
+	std::vector<VkFence>					mReleasedFences;
+	std::vector<VkSemaphore>				mSemaphores;
+	std::vector<VkSemaphore>				mFreeSemaphores;
+	std::deque<std::pair<uint64_t, VkSemaphore>>	mReleasedSemaphores;
+	uint32_t								mFenceHighWater;
+	uint32_t								mSemaphoreHighWater;
+
+public:
+
+	VulkanSyncPool();
+	~VulkanSyncPool();
+
+	bool Initialize(VkDevice device);
+	void Destroy();
+
+	bool AcquireFence(VkFence *fence);
+	void ReleaseFence(VkFence fence);
+	bool ResetReleasedFences();
+
+	bool AcquireSemaphore(VkSemaphore *semaphore);
+	void ReleaseSemaphore(VkSemaphore semaphore, uint64_t value);
+	void RetireSemaphores(uint64_t completedValue);
+
+	void GetStats(VulkanSyncPoolStats *stats) const;
+};
\ No newline at end of file
@@ -0,0 +1,73 @@
+#ifdef _WIN32
+
+#define VK_USE_PLATFORM_WIN32_KHR
+
+#include "VulkanWin32Backend.h"
+#include "Logger.h"
+
+VulkanWin32Backend::VulkanWin32Backend()
+{
+}
+
+VulkanWin32Backend::~VulkanWin32Backend()
+{
+	Destroy();
+}
+
+const char* VulkanWin32Backend::GetSurfaceExtensionName() const
+{
+	return VK_KHR_WIN32_SURFACE_EXTENSION_NAME;
+}
+
+bool VulkanWin32Backend::Create(uint32_t width, uint32_t height, const std::string &title)
+{
+	return mWindow.Create(width, height, title);
+}
+
+void VulkanWin32Backend::Destroy()
+{
+	mWindow.Destroy();
+}
+
+void VulkanWin32Backend::Show()
+{
+	mWindow.Show();
+}
+
+bool VulkanWin32Backend::ProcessEvents()
+{
+	return VulkanWindow::ProcessEvents();
+}
+
+bool VulkanWin32Backend::TakeResize()
+{
+	return mWindow.TakeResize();
+}
+
+bool VulkanWin32Backend::CreateSurface(VkInstance instance, VkSurfaceKHR *surface)
+{
+	VkWin32SurfaceCreateInfoKHR surfaceInfo =
+	{
+		VK_STRUCTURE_TYPE_WIN32_SURFACE_CREATE_INFO_KHR,
+		nullptr,
+		0,
+		GetModuleHandle(nullptr),
+		mWindow.GetHandle()
+	};
+
+	VkResult result = vkCreateWin32SurfaceKHR(
+		instance,
+		&surfaceInfo,
+		nullptr,
+		surface);
+
+	if (result != VK_SUCCESS || *surface == nullptr)
+	{
+		LOG_ERROR("Unable to create Win32 surface");
+		return false;
+	}
+
+	return true;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+
+#ifdef _WIN32
+
+#include "VulkanPresentationBackend.h"
+#include "VulkanWindow.h"
+
+class VulkanWin32Backend : public VulkanPresentationBackend
+{
+private:
+
+	VulkanWindow		mWindow;
+
+public:
+
+	VulkanWin32Backend();
+	~VulkanWin32Backend();
+
+	const char* GetSurfaceExtensionName() const override;
+
+	uint32_t GetWidth() const override
+	{
+		return mWindow.GetWidth();
+	}
+
+	uint32_t GetHeight() const override
+	{
+		return mWindow.GetHeight();
+	}
+
+	bool Create(uint32_t width, uint32_t height, const std::string &title) override;
+	void Destroy() override;
+	void Show() override;
+	bool ProcessEvents() override;
+	bool TakeResize() override;
+
+	bool CreateSurface(VkInstance instance, VkSurfaceKHR *surface) override;
+};
+
+#endif
\ No newline at end of file
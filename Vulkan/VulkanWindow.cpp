@@ -1,8 +1,10 @@
+#ifdef _WIN32
+
 #include "VulkanWindow.h"
 #include "Logger.h"
 
 VulkanWindow::VulkanWindow()
-	: mWidth(0), mHeight(0), mHandle(nullptr)
+	: mWidth(0), mHeight(0), mResized(false), mHandle(nullptr)
 {
 }
 
@@ -65,6 +67,7 @@ bool VulkanWindow::Create(uint32_t width, uint32_t height, const std::string & t
 
 	mWidth = width;
 	mHeight = height;
+	mResized = false;
 	mTitle = title;
 
 	return true;
@@ -85,8 +88,24 @@ void VulkanWindow::Show()
 
 LRESULT VulkanWindow::WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
 {
+	VulkanWindow *window = reinterpret_cast<VulkanWindow*>(GetWindowLongPtr(hWnd, GWLP_USERDATA));
+
 	switch (msg)
 	{
+	case WM_NCCREATE:
+		SetWindowLongPtr(hWnd, GWLP_USERDATA, 
+			reinterpret_cast<LONG_PTR>(reinterpret_cast<CREATESTRUCT*>(lParam)->lpCreateParams));
+		break;
+
+	case WM_SIZE:
+		if (window != nullptr)
+		{
+			window->mWidth = LOWORD(lParam);
+			window->mHeight = HIWORD(lParam);
+			window->mResized = true;
+		}
+		break;
+
 	case WM_CLOSE:
 		PostQuitMessage(0);
 		break;
@@ -111,3 +130,4 @@ bool VulkanWindow::ProcessEvents()
 	return true;
 }
 
+#endif
@@ -1,5 +1,7 @@
 #pragma once
 
+#ifdef _WIN32
+
 #include <Windows.h>
 #include <string>
 
@@ -10,6 +12,7 @@ private:
 	std::string		mTitle;
 	uint32_t		mWidth;
 	uint32_t		mHeight;
+	bool			mResized;
 
 	HWND			mHandle;
 
@@ -38,6 +41,13 @@ public:
 		return mHandle;
 	}
 
+	bool TakeResize()
+	{
+		bool resized = mResized;
+		mResized = false;
+		return resized;
+	}
+
 	bool Create(uint32_t width, uint32_t height, const std::string &title = "Vulkan Window");
 	void Destroy();
 	void Show();
@@ -46,4 +56,6 @@ public:
 
 	static LRESULT CALLBACK WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
 	static bool ProcessEvents();
-};
\ No newline at end of file
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include "WorkerPool.h"
+#include "Logger.h"
+
+WorkerPool::WorkerPool()
+	: mTaskCount(0),
+	mNextTask(0),
+	mActiveThreads(0),
+	mGeneration(0),
+	mExit(false)
+{
+}
+
+WorkerPool::~WorkerPool()
+{
+	Destroy();
+}
+
+bool WorkerPool::Initialize(uint32_t threadCount)
+{
+	if (threadCount == 0)
+	{
+		LOG_ERROR("Worker pool needs at least one thread");
+		return false;
+	}
+
+	mExit = false;
+
+	for (uint32_t index = 0; index < threadCount; index++)
+		mThreads.emplace_back(&WorkerPool::WorkerMain, this, index);
+
+	return true;
+}
+
+void WorkerPool::Destroy()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mExit = true;
+	}
+
+	mWorkCondition.notify_all();
+
+	for (auto& thread : mThreads)
+	{
+		if (thread.joinable())
+			thread.join();
+	}
+
+	mThreads.clear();
+}
+
+void WorkerPool::Dispatch(uint32_t taskCount, const Task &task)
+{
+	if (taskCount == 0)
+		return;
+
+	if (mThreads.empty())
+	{
+		for (uint32_t index = 0; index < taskCount; index++)
+			task(0, index);
+
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(mMutex);
+
+	mTask = task;
+	mTaskCount = taskCount;
+	mNextTask = 0;
+	mActiveThreads = static_cast<uint32_t>(mThreads.size());
+	mGeneration++;
+
+	mWorkCondition.notify_all();
+	mDoneCondition.wait(lock, [this] { return mActiveThreads == 0; });
+
+	mTask = nullptr;
+}
+
+void WorkerPool::WorkerMain(uint32_t threadIndex)
+{
+	uint64_t generation = 0;
+
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mWorkCondition.wait(lock, [this, generation] { return mExit || mGeneration != generation; });
+
+			if (mExit)
+				return;
+
+			generation = mGeneration;
+		}
+
+		for (uint32_t taskIndex = mNextTask++; taskIndex < mTaskCount; taskIndex = mNextTask++)
+			mTask(threadIndex, taskIndex);
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+
+			if (--mActiveThreads == 0)
+				mDoneCondition.notify_one();
+		}
+	}
+}
\ No newline at end of file
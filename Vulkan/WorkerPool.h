@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkerPool
+{
+public:
+
+	typedef std::function<void(uint32_t threadIndex, uint32_t taskIndex)> Task;
+
+private:
+
+	std::vector<std::thread>		mThreads;
+	std::mutex						mMutex;
+	std::condition_variable			mWorkCondition;
+	std::condition_variable			mDoneCondition;
+	Task							mTask;
+	uint32_t						mTaskCount;
+	std::atomic<uint32_t>			mNextTask;
+	uint32_t						mActiveThreads;
+	uint64_t						mGeneration;
+	bool							mExit;
+
+public:
+
+	WorkerPool();
+	~WorkerPool();
+
+	uint32_t GetThreadCount() const
+	{
+		return static_cast<uint32_t>(mThreads.size());
+	}
+
+	bool Initialize(uint32_t threadCount);
+	void Destroy();
+
+	void Dispatch(uint32_t taskCount, const Task &task);
+
+private:
+
+	void WorkerMain(uint32_t threadIndex);
+};
\ No newline at end of file
@@ -1,9 +1,15 @@
+#include <cstdlib>
+#include <cstring>
 #include "VulkanSample.h"
+#include "VulkanHeadlessBackend.h"
 
-int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR pCmdLine, int nCmdShow)
+static int Run(bool headless, uint64_t frameLimit)
 {
 	VulkanSample sample;
 
+	if (headless)
+		sample.SetPresentationBackend(std::unique_ptr<VulkanPresentationBackend>(new VulkanHeadlessBackend(frameLimit)));
+
 	if (sample.Initialize())
 	{
 		sample.PopulateInstanceExtensions();
@@ -11,7 +17,7 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR pCmdLine, int nCm
 
 		sample.CreateVulkanInstance({
 			VK_KHR_SURFACE_EXTENSION_NAME,
-			VK_KHR_WIN32_SURFACE_EXTENSION_NAME
+			sample.GetPresentationSurfaceExtension()
 		});
 
 		sample.PopulatePhysicalDevices();
@@ -26,6 +32,7 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR pCmdLine, int nCm
 
 		sample.PopulateQueueFamilyProperties();
 		sample.SelectQueueFamily(VK_QUEUE_GRAPHICS_BIT);
+		sample.SelectAsyncQueueFamilies();
 
 		sample.PopulatePresentModes();
 		sample.SelectPresentMode(VK_PRESENT_MODE_MAILBOX_KHR);
@@ -44,32 +51,11 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR pCmdLine, int nCm
 		sample.GetQueues(2);
 
 		sample.CreateSwapChain();
-		sample.CreateCommandPool(VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);		
-
-		std::vector<VkCommandBuffer> commandBuffers;
-		sample.AllocateCommandBuffers(1, 
-			VK_COMMAND_BUFFER_LEVEL_PRIMARY, 
-			commandBuffers);
-
-		sample.BeginCommandBuffer(
-			commandBuffers[0], 
-			VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-			VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, 
-			nullptr
-		);
-
-		sample.EndCommandBuffer(commandBuffers[0]);
-		sample.SubmitCommandBuffers(
-			0, 
-			commandBuffers, 
-			{}, 
-			{}, 
-			{},
-			nullptr
-		);
+		sample.CreateFrameContexts(2);
+		sample.StartSubmitThread();
 
 		VkImage image;
-		VkDeviceMemory imageMemory;
+		VulkanAllocation imageAllocation;
 
 		sample.CreateImage(
 			VK_IMAGE_TYPE_2D, 
@@ -80,8 +66,8 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR pCmdLine, int nCm
 			1, 
 			VK_SAMPLE_COUNT_1_BIT, 
 			VK_IMAGE_USAGE_SAMPLED_BIT,
-			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 
-			&imageMemory, 
+			VulkanMemoryUsage::GpuOnly, 
+			&imageAllocation, 
 			&image
 		);
 
@@ -94,13 +80,56 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR pCmdLine, int nCm
 			&imageView
 		);
 
+		VulkanFrameGraph frameGraph;
+		frameGraph.SetSynchronization2(sample.GetCmdPipelineBarrier2());
+
+		uint32_t backBuffer = frameGraph.AddImage("BackBuffer", VK_IMAGE_ASPECT_COLOR_BIT, 1, 1);
+		frameGraph.SetOutput(backBuffer, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, 0, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+
 		sample.ShowVulkanWindow();
-		while (VulkanWindow::ProcessEvents());
+
+		while (sample.ProcessEvents())
+		{
+			VkCommandBuffer commandBuffer;
+
+			if (!sample.BeginFrame(&commandBuffer))
+				break;
+
+			VkImage swapChainImage = sample.GetCurrentSwapChainImage();
+
+			frameGraph.BindImage(backBuffer, swapChainImage, VK_IMAGE_LAYOUT_UNDEFINED, 
+				0, VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+			frameGraph.ClearPasses();
+
+			uint32_t clearPass = frameGraph.AddPass("Clear", [swapChainImage](VkCommandBuffer buffer)
+			{
+				VkClearColorValue clearColor = { { 0.1f, 0.2f, 0.4f, 1.0f } };
+				VkImageSubresourceRange clearRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+
+				vkCmdClearColorImage(
+					buffer,
+					swapChainImage,
+					VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+					&clearColor,
+					1,
+					&clearRange
+				);
+			});
+
+			frameGraph.Write(clearPass, backBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 
+				VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+			if (!frameGraph.Compile() || !frameGraph.Execute(commandBuffer))
+				break;
+
+			if (!sample.EndFrame())
+				break;
+		}
 		
+		sample.DestroyFrameContexts();
 		sample.DestroyImageView(imageView);
-		sample.DestroyImage(image, imageMemory);
-		sample.FreeCommandBuffers(commandBuffers);
-		sample.DestroyCommandPool();
+		sample.DestroyImage(image, imageAllocation);
 		sample.DestroySwapChain();
 		sample.DestroyPresentationSurface();
 		sample.DestroyVulkanWindow();
@@ -109,4 +138,34 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR pCmdLine, int nCm
 	}
 
 	return 0;
-}
\ No newline at end of file
+}
+
+#ifdef _WIN32
+static uint64_t ParseFrameLimit(const char *commandLine)
+{
+	const char *frames = commandLine != nullptr ? strstr(commandLine, "--frames") : nullptr;
+
+	if (frames == nullptr)
+		return 0;
+
+	return strtoull(frames + strlen("--frames"), nullptr, 10);
+}
+
+int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR pCmdLine, int nCmdShow)
+{
+	return Run(pCmdLine != nullptr && strstr(pCmdLine, "--headless") != nullptr, ParseFrameLimit(pCmdLine));
+}
+#else
+int main(int argc, char **argv)
+{
+	uint64_t frameLimit = 0;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+			frameLimit = strtoull(argv[++i], nullptr, 10);
+	}
+
+	return Run(true, frameLimit);
+}
+#endif
\ No newline at end of file